@@ -0,0 +1,92 @@
+// MIT License
+
+// Copyright (c) 2020 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "cart.h"
+
+static unsigned char* readFile(const char* path, int* size)
+{
+	unsigned char* buffer = NULL;
+	FILE* file = fopen(path, "rb");
+
+	if(file)
+	{
+		fseek(file, 0, SEEK_END);
+		*size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		if((buffer = (unsigned char*)malloc(*size)) && fread(buffer, *size, 1, file) != 1)
+		{
+			free(buffer);
+			buffer = NULL;
+		}
+
+		fclose(file);
+	}
+	else printf("cannot open %s\n", path);
+
+	return buffer;
+}
+
+int main(int argc, char** argv)
+{
+	int res = -1;
+
+	if(argc == 4)
+	{
+		int baseSize = 0, targetSize = 0;
+		unsigned char* base = readFile(argv[1], &baseSize);
+		unsigned char* target = readFile(argv[2], &targetSize);
+
+		if(base && target)
+		{
+			// the target and a 2 byte op per chunk of at least 4 bytes at worst
+			int deltaSize = 64 + targetSize + targetSize / 2;
+			unsigned char* delta = (unsigned char*)malloc(deltaSize);
+
+			if(delta && (deltaSize = tic_cart_delta(base, baseSize, target, targetSize, delta, deltaSize)))
+			{
+				FILE* file = fopen(argv[3], "wb");
+
+				if(file)
+				{
+					fwrite(delta, deltaSize, 1, file);
+					fclose(file);
+
+					printf("delta %d bytes, target %d bytes\n", deltaSize, targetSize);
+					res = 0;
+				}
+				else printf("cannot open delta file\n");
+			}
+			else printf("cannot make the delta\n");
+
+			free(delta);
+		}
+
+		free(base);
+		free(target);
+	}
+	else printf("usage: cartdelta <old cart> <new cart> <delta>\n");
+
+	return res;
+}
@@ -11,11 +11,14 @@ macro(MACRO_CORE SCRIPT DEFINE BUILD_DEPRECATED)
         ${TIC80CORE_DIR}/core/draw.c
         ${TIC80CORE_DIR}/core/io.c
         ${TIC80CORE_DIR}/core/sound.c
+        ${TIC80CORE_DIR}/core/alloc.c
+        ${TIC80CORE_DIR}/core/jobs.c
         ${TIC80CORE_DIR}/tic.c
         ${TIC80CORE_DIR}/cart.c
         ${TIC80CORE_DIR}/tools.c
         ${TIC80CORE_DIR}/zip.c
         ${TIC80CORE_DIR}/tilesheet.c
+        ${TIC80CORE_DIR}/ext/md5.c
     )
 
     if(BUILD_WITH_LUA)
@@ -137,6 +140,12 @@ macro(MACRO_CORE SCRIPT DEFINE BUILD_DEPRECATED)
         target_link_libraries(tic80core${SCRIPT} m)
     endif()
 
+    if(BUILD_WITH_JOBS)
+        find_package(Threads REQUIRED)
+        target_compile_definitions(tic80core${SCRIPT} PRIVATE TIC_BUILD_WITH_JOBS)
+        target_link_libraries(tic80core${SCRIPT} Threads::Threads)
+    endif()
+
     target_compile_definitions(tic80core${SCRIPT} PUBLIC ${DEFINE})
 
 endmacro()
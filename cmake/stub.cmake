@@ -14,8 +14,7 @@ if(BUILD_STUB)
             src/studio/screens/start.c
             src/studio/config.c
             src/studio/studio.c
-            src/studio/fs.c
-            src/ext/md5.c)
+            src/studio/fs.c)
 
         if(WIN32)
 
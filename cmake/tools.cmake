@@ -1,5 +1,5 @@
 ################################
-# bin2txt cart2prj prj2cart xplode wasmp2cart
+# bin2txt cart2prj prj2cart xplode wasmp2cart cartdelta
 ################################
 
 if(BUILD_DEMO_CARTS)
@@ -18,6 +18,10 @@ if(BUILD_DEMO_CARTS)
     target_include_directories(wasmp2cart PRIVATE ${CMAKE_SOURCE_DIR}/src ${CMAKE_SOURCE_DIR}/include)
     target_link_libraries(wasmp2cart tic80core)
 
+    add_executable(cartdelta ${TOOLS_DIR}/cartdelta.c)
+    target_include_directories(cartdelta PRIVATE ${CMAKE_SOURCE_DIR}/src ${CMAKE_SOURCE_DIR}/include)
+    target_link_libraries(cartdelta tic80core)
+
     add_executable(bin2txt ${TOOLS_DIR}/bin2txt.c)
     target_link_libraries(bin2txt zlib)
 
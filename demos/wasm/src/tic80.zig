@@ -143,6 +143,7 @@ pub const raw = struct {
     pub extern fn trace(text: [*:0]const u8, color: i32) void;
     pub extern fn tstamp() u64;
     pub extern fn vbank(bank: i32) u8;
+    pub extern fn rowfx(address: i32, mask: i32, bank: i32) void;
 };
 
 // -----
@@ -422,6 +423,7 @@ pub const peek4 = raw.peek4;
 pub const peek2 = raw.peek2;
 pub const peek1 = raw.peek1;
 pub const vbank = raw.vbank;
+pub const rowfx = raw.rowfx;
 
 // SYSTEM
 
@@ -174,11 +174,56 @@ typedef struct
 
 } tic80_input;
 
+typedef struct
+{
+    // time spent in the last frame, in microseconds
+    struct
+    {
+        u32 tick;       // TIC() callback
+        u32 scanline;   // SCN() callbacks
+        u32 border;     // BDR() callbacks
+        u32 draw;       // draw API calls made by the script
+        u32 blit;       // screen blit without the callbacks
+        u32 sound;      // sound synthesis
+    } time;
+
+    // bytes allocated by the script VM, set only if the language can tell
+    u32 heap;
+    bool hasHeap;
+
+    // the number of API calls made by the script in the last frame
+    struct
+    {
+        s32 count;
+        const char* const* names;
+        const u32* values;
+    } calls;
+} tic80_stats;
+
 TIC80_API tic80* tic80_create(s32 samplerate, tic80_pixel_color_format format);
 TIC80_API void tic80_load(tic80* tic, void* cart, s32 size);
+
+// a parsed cart, it has no pointers inside, so it can be placed in shared memory
+// and loaded by any number of instances, tic80_cart_size() bytes are needed for it
+typedef struct tic80_cart tic80_cart;
+
+TIC80_API s32 tic80_cart_size();
+TIC80_API void tic80_cart_parse(tic80_cart* dst, const void* cart, s32 size);
+
+// a parsed cart on the heap shared by the instances, every tic80_load_ex holds
+// a reference until the next load or tic80_delete, it's freed with the last one
+TIC80_API tic80_cart* tic80_cart_create(const void* cart, s32 size);
+TIC80_API void tic80_cart_release(tic80_cart* cart);
+
+// loads the parsed cart without copying it, the code and binary are used in place
+// and a bank is copied to the instance only when sync() writes to it, the cart
+// from tic80_cart_parse must stay unchanged and alive until the next load or tic80_delete
+TIC80_API void tic80_load_ex(tic80* tic, const tic80_cart* cart);
 TIC80_API void tic80_tick(tic80* tic, tic80_input input, u64 (*counter)(), u64 (*freq)());
 TIC80_API void tic80_sound(tic80* tic);
 TIC80_API void tic80_delete(tic80* tic);
+TIC80_API void tic80_stats_enable(tic80* tic, bool enable);
+TIC80_API const tic80_stats* tic80_stats_get(tic80* tic);
 
 #ifdef __cplusplus
 }
@@ -31,6 +31,10 @@
 #define FOR_EACH_LANG_END }
 
 
+// the watchdog budget of the studio, seconds of a fast interpreter,
+// it stops the hung carts and leaves the heavy ones alone
+#define TIC_WATCHDOG_BUDGET 2000000000ull
+
 typedef struct { u8 index; tic_flip flip; tic_rotate rotate; } RemapResult;
 typedef void(*RemapFunc)(void*, s32 x, s32 y, RemapResult* result);
 
@@ -39,6 +43,8 @@ typedef void(*ErrorOutput)(void*, const char*);
 typedef void(*ExitCallback)(void*);
 typedef u64(*CounterCallback)(void*);
 typedef u64(*FreqCallback)(void*);
+typedef void*(*CacheLoadCallback)(void*, const char* name, const char* hash, s32* size);
+typedef void(*CacheSaveCallback)(void*, const char* name, const char* hash, const void* buffer, s32 size);
 
 typedef struct
 {
@@ -50,6 +56,16 @@ typedef struct
     FreqCallback freq;
     u64 start;
 
+    // optional storage for compiled code keyed by the md5 of the source in hex,
+    // the loaded buffer must be allocated with malloc
+    CacheLoadCallback cacheLoad;
+    CacheSaveCallback cacheSave;
+
+    // VM instructions a tick (or a blit with its callbacks) can run
+    // before the script is stopped with an error, the tick starting
+    // the cart gets 4 times more, 0 turns the watchdog off
+    u64 budget;
+
     void* data;
 } tic_tick_data;
 
@@ -75,6 +91,21 @@ typedef struct
     void* data;
 } tic_blit_callback;
 
+typedef enum
+{
+    tic_gc_auto,
+    tic_gc_incremental,
+    tic_gc_generational,
+    tic_gc_manual,
+} tic_gc_mode;
+
+typedef enum
+{
+    tic_compile_done,
+    tic_compile_error,
+    tic_compile_binary_used,
+} tic_compile_result;
+
 typedef struct
 {
     u8 id;
@@ -86,13 +117,34 @@ typedef struct
         bool(*init)(tic_mem* memory, const char* code);
         void(*close)(tic_mem* memory);
 
+        // optional, creates the VM without the cart code in the script heap,
+        // init gets it in currentVM and only loads the code
+        void*(*create)(tic_mem* memory);
+
         tic_tick tick;
         tic_boot boot;
         tic_blit_callback callback;
+
+        // optional, looks up the script callbacks once per frame and
+        // clears the ones the script doesn't define to skip their dispatch
+        void(*resolve)(tic_mem* memory, tic_blit_callback* callback);
+
+        // optional garbage collector control, the step is called after every TIC()
+        // and must do work bounded by the budget in KB, so the engines without
+        // an incremental collector leave it NULL,
+        // the heap returns the number of bytes allocated by the VM
+        struct
+        {
+            void(*mode)(tic_mem* memory, tic_gc_mode mode);
+            void(*step)(tic_mem* memory, s32 budget);
+            u32(*heap)(tic_mem* memory);
+        } gc;
     };
 
     const tic_outline_item* (*getOutline)(const char* code, s32* size);
     void (*eval)(tic_mem* tic, const char* code);
+    void* (*compile)(tic_mem* tic, const char* code, s32* size);
+    void (*profile)(tic_mem* tic, bool enable);
 
     const char* blockCommentStart;
     const char* blockCommentEnd;
@@ -773,6 +825,25 @@ enum
         tic_mem*, s32 bank)                                                                                             \
                                                                                                                         \
                                                                                                                         \
+    macro(rowfx,                                                                                                        \
+        "rowfx(address=-1 mask=7 bank=0)",                                                                              \
+                                                                                                                        \
+        "Sets a table in RAM with the palette, the offset and the border color for every row of the screen, "           \
+        "so the raster effects don't need to change them in SCN() or BDR().\n"                                          \
+        "The table has an entry for each of the 144 rows, the border included, "                                        \
+        "with the fields selected by the mask in this order:\n"                                                         \
+        "1 - the palette, 48 bytes like at 0x3FC0\n"                                                                    \
+        "2 - the x and y offset, 2 signed bytes like at 0x3FF9\n"                                                       \
+        "4 - the border color, 1 byte, only used in the vbank 0 table\n"                                                \
+        "The blit reads the table of each vbank every frame after SCN() and BDR(), "                                    \
+        "fill it with poke() or memcpy() and call rowfx() to turn it off.",                                             \
+        3,                                                                                                              \
+        0,                                                                                                              \
+        0,                                                                                                              \
+        void,                                                                                                           \
+        tic_mem*, s32 address, u8 mask, s32 bank)                                                                       \
+                                                                                                                        \
+                                                                                                                        \
     macro(reset,                                                                                                        \
         "reset()",                                                                                                      \
                                                                                                                         \
@@ -835,6 +906,14 @@ enum
 TIC_API_LIST(TIC_API_DEF)
 #undef TIC_API_DEF
 
+typedef enum
+{
+#define TIC_API_ID_DEF(name, ...) tic_api_id_##name,
+    TIC_API_LIST(TIC_API_ID_DEF)
+#undef TIC_API_ID_DEF
+    tic_api_id_count
+} tic_api_id;
+
 struct tic_mem
 {
     tic80           product;
@@ -867,6 +946,9 @@ struct tic_mem
 };
 
 tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format);
+// the threads are used to split the large map() and tri() calls into bands
+// and to rasterize the draw calls of the carts with the deferred rendering
+tic_mem* tic_core_create_ex(s32 samplerate, tic80_pixel_color_format format, s32 threads);
 void tic_core_close(tic_mem* memory);
 void tic_core_pause(tic_mem* memory);
 void tic_core_resume(tic_mem* memory);
@@ -876,7 +958,24 @@ void tic_core_tick_end(tic_mem* memory);
 void tic_core_synth_sound(tic_mem* tic);
 void tic_core_blit(tic_mem* tic);
 void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb);
+// borrows the read-only cart until the next call, the code, binary and language
+// are used in place and a bank is copied to tic->cart only when sync() writes to it,
+// NULL returns to tic->cart without restoring the banks that were never copied
+void tic_core_load_rom(tic_mem* memory, const tic_cartridge* rom);
+// the cart the running code, binary and language are taken from
+const tic_cartridge* tic_core_rom(tic_mem* memory);
+// the current contents of the bank, from tic->cart or from the borrowed rom
+const tic_bank* tic_core_bank(tic_mem* memory, s32 bank);
 const tic_script_config* tic_core_script_config(tic_mem* memory);
+// embeds the bytecode into the binary section unless it holds the cart data
+tic_compile_result tic_core_compile(tic_mem* memory);
+// the bytecode embedded in the cart is executed only when it's trusted
+void tic_core_trust_bytecode(tic_mem* memory, bool trust);
+void tic_core_stats_enable(tic_mem* memory, bool enable);
+const tic80_stats* tic_core_stats(tic_mem* memory);
+bool tic_core_profile_start(tic_mem* memory);
+void tic_core_profile_stop(tic_mem* memory);
+void* tic_core_profile_export(tic_mem* memory, s32* size);
 
 #define VBANK(tic, bank)                                \
     bool MACROVAR(_bank_) = tic_api_vbank(tic, bank);   \
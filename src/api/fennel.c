@@ -38,48 +38,66 @@ static const char* execute_fennel_src = FENNEL_CODE(
   if(not ok) then return msg end
 );
 
-static bool initFennel(tic_mem* tic, const char* code)
-{
-    tic_core* core = (tic_core*)tic;
-    closeLua(tic);
+static const char* setup_fennel_src = FENNEL_CODE(
+  io = { read = true }
+  debug.traceback = require("fennel").traceback
+);
 
-    lua_State* lua = core->currentVM = luaL_newstate();
-    lua_open_builtins(lua);
+static const char* compile_fennel_src = FENNEL_CODE(
+  local fennel = require("fennel")
+  local opts = {allowedGlobals = false, ["error-pinpoint"]={">>", "<<"}, filename = "game.fnl"}
+  local src = ...
+  if(src:find("\n;; +strict: *true")) then opts.allowedGlobals = nil end
+  local ok, lua, sourcemap = pcall(fennel.compileString, src, opts)
+  if(not ok) then return nil, lua end
+  local lines = {}
+  for i, v in ipairs(sourcemap) do
+    lines[i] = string.format("{%s,%s}", v[1] and string.format("%q", v[1]) or "nil", v[2] or "nil")
+  end
+  return lua, "{" .. table.concat(lines, ",") .. "}"
+);
 
-    initLuaAPI(core);
+static const char* map_fennel_src = FENNEL_CODE(
+  local chunkname, map = ...
+  local sourcemap = load("return " .. map)()
+  sourcemap.short_src, sourcemap.key = "game.fnl", chunkname
+  require("fennel.compiler").sourcemap[chunkname] = sourcemap
+);
 
-    {
-        lua_State* fennel = core->currentVM;
+static const char FennelCacheName[] = "fennel.lua";
+static const char FennelChunkName[] = "@game.fnl";
 
-        lua_settop(fennel, 0);
+static void* createFennel(tic_mem* tic)
+{
+    lua_State* fennel = createLua(tic);
 
-        if (luaL_loadbuffer(fennel, (const char *)loadfennel_lua,
-                            loadfennel_lua_len, "fennel.lua") != LUA_OK)
-        {
-            core->data->error(core->data->data, "failed to load fennel compiler");
-            return false;
-        }
+    lua_settop(fennel, 0);
 
-        lua_call(fennel, 0, 0);
+    if (luaL_loadbuffer(fennel, (const char *)loadfennel_lua,
+                        loadfennel_lua_len, "fennel.lua") != LUA_OK)
+        return NULL;
 
-        if (luaL_loadbuffer(fennel, execute_fennel_src, strlen(execute_fennel_src), "execute_fennel") != LUA_OK)
-        {
-            core->data->error(core->data->data, "failed to load fennel compiler");
-            return false;
-        }
+    lua_call(fennel, 0, 0);
 
-        lua_pushstring(fennel, code);
-        lua_call(fennel, 1, 1);
-        const char* err = lua_tostring(fennel, -1);
+    if (luaL_loadbuffer(fennel, setup_fennel_src, strlen(setup_fennel_src), "setup_fennel") != LUA_OK)
+        return NULL;
 
-        if (err)
-        {
-            core->data->error(core->data->data, err);
-            return false;
-        }
+    lua_call(fennel, 0, 0);
+
+    return fennel;
+}
+
+static bool initFennel(tic_mem* tic, const char* code)
+{
+    tic_core* core = (tic_core*)tic;
+
+    if (!core->currentVM && !createFennel(tic))
+    {
+        core->data->error(core->data->data, "failed to load fennel compiler");
+        return false;
     }
 
-    return true;
+    return initTranspiledLua(tic, FennelCacheName, FennelChunkName, compile_fennel_src, map_fennel_src, code);
 }
 
 static const char* const FennelKeywords [] =
@@ -191,6 +209,7 @@ tic_script_config FennelSyntaxConfig =
     {
       .init               = initFennel,
       .close              = closeLua,
+      .create             = createFennel,
       .tick               = callLuaTick,
       .boot               = callLuaBoot,
 
@@ -200,10 +219,20 @@ tic_script_config FennelSyntaxConfig =
         .border         = callLuaBorder,
         .menu           = callLuaMenu,
       },
+
+      .resolve            = resolveLuaCallbacks,
+
+      .gc                 =
+      {
+        .mode           = setLuaGCMode,
+        .step           = stepLuaGC,
+        .heap           = getLuaHeap,
+      },
     },
 
     .getOutline         = getFennelOutline,
     .eval               = evalFennel,
+    .profile            = profileLua,
 
     .blockCommentStart  = NULL,
     .blockCommentEnd    = NULL,
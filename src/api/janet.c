@@ -71,6 +71,7 @@ static Janet janet_clip(int32_t argc, Janet* argv);
 static Janet janet_music(int32_t argc, Janet* argv);
 static Janet janet_sync(int32_t argc, Janet* argv);
 static Janet janet_vbank(int32_t argc, Janet* argv);
+static Janet janet_rowfx(int32_t argc, Janet* argv);
 static Janet janet_reset(int32_t argc, Janet* argv);
 static Janet janet_key(int32_t argc, Janet* argv);
 static Janet janet_keyp(int32_t argc, Janet* argv);
@@ -86,6 +87,7 @@ static void callJanetIntCallback(tic_mem* memory, s32 value, void* data, const c
 static void callJanetScanline(tic_mem* memory, s32 row, void* data);
 static void callJanetBorder(tic_mem* memory, s32 row, void* data);
 static void callJanetMenu(tic_mem* memory, s32 index, void* data);
+static void resolveJanetCallbacks(tic_mem* memory, tic_blit_callback* callback);
 static const tic_outline_item* getJanetOutline(const char* code, s32* size);
 
 /* ***************** */
@@ -133,6 +135,7 @@ static const JanetReg janet_c_functions[] =
     {"music", janet_music, NULL},
     {"sync", janet_sync, NULL},
     {"vbank", janet_vbank, NULL},
+    {"rowfx", janet_rowfx, NULL},
     {"reset", janet_reset, NULL},
     {"key", janet_key, NULL},
     {"keyp", janet_keyp, NULL},
@@ -975,6 +978,19 @@ static Janet janet_vbank(int32_t argc, Janet* argv)
     return janet_wrap_integer(tic_api_vbank(memory, bank));
 }
 
+static Janet janet_rowfx(int32_t argc, Janet* argv)
+{
+    janet_arity(argc, 0, 3);
+
+    s32 address = janet_optinteger(argv, argc, 0, -1);
+    u8 mask = janet_optinteger(argv, argc, 1, TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER);
+    s32 bank = janet_optinteger(argv, argc, 2, 0);
+
+    tic_mem* memory = (tic_mem*)getJanetMachine();
+    tic_api_rowfx(memory, address, mask, bank);
+    return janet_wrap_nil();
+}
+
 static Janet janet_reset(int32_t argc, Janet* argv)
 {
     janet_fixarity(argc, 0);
@@ -1206,6 +1222,25 @@ static void callJanetMenu(tic_mem* tic, s32 index, void* data)
     callJanetIntCallback(tic, index, data, MENU_FN);
 }
 
+static bool hasJanetFunction(tic_core* core, const char* name)
+{
+    Janet fn;
+    (void)janet_resolve(core->currentVM, janet_csymbol(name), &fn);
+
+    return janet_type(fn) == JANET_FUNCTION;
+}
+
+static void resolveJanetCallbacks(tic_mem* tic, tic_blit_callback* callback)
+{
+    tic_core* core = (tic_core*)tic;
+
+    if (!hasJanetFunction(core, SCN_FN) && !hasJanetFunction(core, "scanline"))
+        callback->scanline = NULL;
+
+    if (!hasJanetFunction(core, BDR_FN))
+        callback->border = NULL;
+}
+
 static const tic_outline_item* getJanetOutline(const char* code, s32* size)
 {
     enum{Size = sizeof(tic_outline_item)};
@@ -1284,6 +1319,8 @@ const tic_script_config JanetSyntaxConfig =
         .menu           = callJanetMenu,
     },
 
+    .resolve            = resolveJanetCallbacks,
+
     .getOutline         = getJanetOutline,
     .eval               = evalJanet,
 
@@ -108,6 +108,33 @@ static void js_std_dump_error(JSContext *ctx)
     JS_FreeValue(ctx, exception_val);
 }
 
+// callbacks resolved once per frame by resolveJavascriptCallbacks(),
+// they belong to the runtime and are kept in its opaque
+typedef struct
+{
+    JSValue global;
+    JSValue scanline;
+    JSValue legacy;
+    JSValue border;
+} JsCallbacks;
+
+static inline JsCallbacks* getCallbacks(JSContext *ctx)
+{
+    return JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+}
+
+static void freeJavascriptCallbacks(JSContext* ctx)
+{
+    JsCallbacks* callbacks = getCallbacks(ctx);
+    JSValue* values[] = {&callbacks->global, &callbacks->scanline, &callbacks->legacy, &callbacks->border};
+
+    for(s32 i = 0; i < COUNT_OF(values); i++)
+    {
+        JS_FreeValue(ctx, *values[i]);
+        *values[i] = JS_UNDEFINED;
+    }
+}
+
 static void closeJavascript(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
@@ -115,7 +142,10 @@ static void closeJavascript(tic_mem* tic)
 
     if(ctx)
     {
+        freeJavascriptCallbacks(ctx);
+
         JSRuntime *rt = JS_GetRuntime(ctx);
+        free(JS_GetRuntimeOpaque(rt));
         JS_FreeContext(ctx);
         JS_FreeRuntime(rt);
         core->currentVM = NULL;
@@ -961,6 +991,19 @@ static JSValue js_sync(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueC
     return JS_UNDEFINED;
 }
 
+static JSValue js_rowfx(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
+{
+    tic_mem* tic = (tic_mem*)getCore(ctx);
+
+    s32 address = getInteger2(ctx, argv[0], -1);
+    u8 mask = getInteger2(ctx, argv[1], TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER);
+    s32 bank = getInteger2(ctx, argv[2], 0);
+
+    tic_api_rowfx(tic, address, mask, bank);
+
+    return JS_UNDEFINED;
+}
+
 static JSValue js_reset(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
 {
     tic_core* core = getCore(ctx);
@@ -995,17 +1038,96 @@ static JSValue js_fset(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueC
     return JS_UNDEFINED;
 }
 
+static const char JsCacheName[] = "js";
+
+static JSValue compileJs(JSContext* ctx, const char* code)
+{
+    return JS_Eval(ctx, code, strlen(code), "index.js", JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+}
+
+// QuickJS keeps its own heap counters, they drive the GC
+static void* jsMalloc(JSMallocState* state, size_t size)
+{
+    void* ptr = tic_script_alloc_malloc(state->opaque, size);
+
+    if(ptr)
+    {
+        state->malloc_count++;
+        state->malloc_size += size;
+    }
+
+    return ptr;
+}
+
+static void jsFree(JSMallocState* state, void* ptr)
+{
+    if(ptr)
+    {
+        state->malloc_count--;
+        state->malloc_size -= tic_script_alloc_size(ptr);
+        tic_script_alloc_free(state->opaque, ptr);
+    }
+}
+
+static void* jsRealloc(JSMallocState* state, void* ptr, size_t size)
+{
+    if(!ptr)
+        return size ? jsMalloc(state, size) : NULL;
+
+    if(!size)
+    {
+        jsFree(state, ptr);
+        return NULL;
+    }
+
+    size_t prev = tic_script_alloc_size(ptr);
+    void* data = tic_script_alloc_realloc(state->opaque, ptr, size);
+
+    if(data)
+        state->malloc_size += tic_script_alloc_size(data) - prev;
+
+    return data;
+}
+
+static size_t jsUsableSize(const void* ptr)
+{
+    return tic_script_alloc_size(ptr);
+}
+
+static const JSMallocFunctions JsMallocFunctions =
+{
+    .js_malloc = jsMalloc,
+    .js_free = jsFree,
+    .js_realloc = jsRealloc,
+    .js_malloc_usable_size = jsUsableSize,
+};
+
+// QuickJS polls the handler every JS_INTERRUPT_COUNTER calls and branches
+#define JS_INTERRUPT_COUNTER 10000
+
+static s32 jsInterrupt(JSRuntime* rt, void* opaque)
+{
+    return tic_core_watchdog(opaque, JS_INTERRUPT_COUNTER);
+}
+
 static bool initJavascript(tic_mem* tic, const char* code)
 {
     closeJavascript(tic);
 
-    JSRuntime *rt = JS_NewRuntime();
+    tic_core* core = (tic_core*)tic;
+
+    JSRuntime *rt = JS_NewRuntime2(&JsMallocFunctions, &core->alloc);
     JSContext* ctx = JS_NewContext(rt);
 
-    tic_core* core = (tic_core*)tic;
+    JS_SetInterruptHandler(rt, jsInterrupt, core);
+
     core->currentVM = ctx;
     JS_SetContextOpaque(ctx, core);
 
+    JsCallbacks* callbacks = malloc(sizeof(JsCallbacks));
+    *callbacks = (JsCallbacks){JS_UNDEFINED, JS_UNDEFINED, JS_UNDEFINED, JS_UNDEFINED};
+    JS_SetRuntimeOpaque(rt, callbacks);
+
     {
         JSValue global = JS_GetGlobalObject(ctx);
 
@@ -1023,7 +1145,46 @@ static bool initJavascript(tic_mem* tic, const char* code)
         JS_FreeValue(ctx, global);
     }
 
-    JSValue ret = JS_Eval(ctx, code, strlen(code), "index.js", JS_EVAL_TYPE_GLOBAL);
+    JSValue func = JS_UNDEFINED;
+
+    {
+        s32 size = 0;
+        const void* bytecode = tic_core_cache_load(tic, JsCacheName, code, &size);
+
+        if(bytecode)
+        {
+            func = JS_ReadObject(ctx, bytecode, size, JS_READ_OBJ_BYTECODE);
+
+            // incompatible bytecode, fallback to the source
+            if (JS_IsException(func))
+            {
+                JS_FreeValue(ctx, JS_GetException(ctx));
+                func = JS_UNDEFINED;
+            }
+        }
+    }
+
+    if(JS_IsUndefined(func))
+    {
+        func = compileJs(ctx, code);
+
+        if (JS_IsException(func))
+        {
+            js_std_dump_error(ctx);
+            return false;
+        }
+
+        size_t size = 0;
+        u8* bytecode = JS_WriteObject(ctx, &size, func, JS_WRITE_OBJ_BYTECODE);
+
+        if(bytecode)
+        {
+            tic_core_cache_save(tic, JsCacheName, code, bytecode, (s32)size);
+            js_free(ctx, bytecode);
+        }
+    }
+
+    JSValue ret = JS_EvalFunction(ctx, func);
     if (JS_IsException(ret))
     {
         js_std_dump_error(ctx);
@@ -1035,6 +1196,36 @@ static bool initJavascript(tic_mem* tic, const char* code)
     return true;
 }
 
+static void* compileJavascript(tic_mem* tic, const char* code, s32* size)
+{
+    JSRuntime *rt = JS_NewRuntime();
+    JSContext* ctx = JS_NewContext(rt);
+    void* data = NULL;
+
+    JSValue func = compileJs(ctx, code);
+
+    if (!JS_IsException(func))
+    {
+        size_t len = 0;
+        u8* bytecode = JS_WriteObject(ctx, &len, func, JS_WRITE_OBJ_BYTECODE);
+
+        if(bytecode)
+        {
+            data = malloc(len);
+            memcpy(data, bytecode, len);
+            *size = (s32)len;
+
+            js_free(ctx, bytecode);
+        }
+    }
+
+    JS_FreeValue(ctx, func);
+    JS_FreeContext(ctx);
+    JS_FreeRuntime(rt);
+
+    return data;
+}
+
 static bool callFunc1(JSContext* ctx, JSValue func, JSValue this_val, JSValue value)
 {
     JSValue ret = JS_Call(ctx, func, this_val, 1, (JSValueConst[]){value});
@@ -1136,17 +1327,72 @@ static void callJavascriptIntCallback(tic_mem* tic, s32 value, void* data, const
     JS_FreeValue(ctx, global);
 }
 
+static bool resolveJavascriptCallback(JSContext* ctx, const char* name, JSValue* func)
+{
+    *func = JS_GetPropertyStr(ctx, getCallbacks(ctx)->global, name);
+
+    if(JS_IsFunction(ctx, *func))
+        return true;
+
+    JS_FreeValue(ctx, *func);
+    *func = JS_UNDEFINED;
+
+    return false;
+}
+
+static void resolveJavascriptCallbacks(tic_mem* tic, tic_blit_callback* callback)
+{
+    tic_core* core = (tic_core*)tic;
+    JSContext* ctx = core->currentVM;
+
+    if(ctx)
+    {
+        JsCallbacks* callbacks = getCallbacks(ctx);
+
+        freeJavascriptCallbacks(ctx);
+        callbacks->global = JS_GetGlobalObject(ctx);
+
+        bool scanline = resolveJavascriptCallback(ctx, SCN_FN, &callbacks->scanline);
+
+        // old scanline
+        if(resolveJavascriptCallback(ctx, "scanline", &callbacks->legacy))
+            scanline = true;
+
+        if(!scanline)
+            callback->scanline = NULL;
+
+        if(!resolveJavascriptCallback(ctx, BDR_FN, &callbacks->border))
+            callback->border = NULL;
+    }
+}
+
+static void callJavascriptResolvedCallback(JSContext* ctx, JSValue func, s32 value)
+{
+    if(JS_IsFunction(ctx, func))
+        callFunc1(ctx, func, getCallbacks(ctx)->global, JS_NewInt32(ctx, value));
+}
+
 static void callJavascriptScanline(tic_mem* tic, s32 row, void* data)
 {
-    callJavascriptIntCallback(tic, row, data, SCN_FN);
+    tic_core* core = (tic_core*)tic;
+    JSContext* ctx = core->currentVM;
 
-    // try to call old scanline
-    callJavascriptIntCallback(tic, row, data, "scanline");
+    if(ctx)
+    {
+        callJavascriptResolvedCallback(ctx, getCallbacks(ctx)->scanline, row);
+
+        // try to call old scanline
+        callJavascriptResolvedCallback(ctx, getCallbacks(ctx)->legacy, row);
+    }
 }
 
 static void callJavascriptBorder(tic_mem* tic, s32 row, void* data)
 {
-    callJavascriptIntCallback(tic, row, data, BDR_FN);
+    tic_core* core = (tic_core*)tic;
+    JSContext* ctx = core->currentVM;
+
+    if(ctx)
+        callJavascriptResolvedCallback(ctx, getCallbacks(ctx)->border, row);
 }
 
 static void callJavascriptMenu(tic_mem* tic, s32 index, void* data)
@@ -1171,6 +1417,22 @@ static void callJavascriptBoot(tic_mem* tic)
     JS_FreeValue(ctx, global);
 }
 
+static u32 getJavascriptHeap(tic_mem* tic)
+{
+    tic_core* core = (tic_core*)tic;
+    JSContext* ctx = core->currentVM;
+
+    if(ctx)
+    {
+        // walks the whole heap, only called when the stats are enabled
+        JSMemoryUsage usage;
+        JS_ComputeMemoryUsage(JS_GetRuntime(ctx), &usage);
+        return (u32)usage.malloc_size;
+    }
+
+    return 0;
+}
+
 static const char* const JsKeywords [] =
 {
     "await", "break", "case", "catch", "class", "const", "continue", "debugger", 
@@ -1266,10 +1528,18 @@ const tic_script_config JsSyntaxConfig =
         .border         = callJavascriptBorder,
         .menu           = callJavascriptMenu,
       },
+
+      .resolve            = resolveJavascriptCallbacks,
+
+      .gc                 =
+      {
+        .heap           = getJavascriptHeap,
+      },
     },
 
     .getOutline         = getJsOutline,
     .eval               = evalJs,
+    .compile            = compileJavascript,
 
     .blockCommentStart  = "/*",
     .blockCommentEnd    = "*/",
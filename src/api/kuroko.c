@@ -607,6 +607,17 @@ KRK_Function(vbank) {
     return INTEGER_VAL(result);
 }
 
+KRK_Function(rowfx) {
+    int address = -1, mask = TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER, bank = 0;
+
+    if (!krk_parseArgs("|iii", (const char*[]){"address","mask","bank"},
+        &address, &mask, &bank)) return NONE_VAL();
+
+    tic_api_rowfx(machine, address, mask, bank);
+
+    return NONE_VAL();
+}
+
 KRK_Function(reset) {
     tic_api_reset(machine);
     return NONE_VAL();
@@ -807,6 +818,12 @@ static void callKurokoBorder(tic_mem* tic, s32 row, void* data) {
     handleException(tic);
 }
 
+static void resolveKurokoCallbacks(tic_mem* tic, tic_blit_callback* callback) {
+    KrkValue func;
+    if (!krk_tableGet_fast(&mainModule->fields, S(SCN_FN), &func)) callback->scanline = NULL;
+    if (!krk_tableGet_fast(&mainModule->fields, S(BDR_FN), &func)) callback->border = NULL;
+}
+
 static void callKurokoMenu(tic_mem* tic, s32 index, void* data) {
     KrkValue func;
     if (!krk_tableGet_fast(&mainModule->fields, S(MENU_FN), &func)) return;
@@ -868,6 +885,8 @@ const tic_script_config KurokoSyntaxConfig = {
         .menu           = callKurokoMenu,
     },
 
+    .resolve            = resolveKurokoCallbacks,
+
     .getOutline         = getKurokoOutline,
     .eval               = evalKuroko,
 
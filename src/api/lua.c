@@ -24,13 +24,19 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
 #include <lua.h>
 #include <lauxlib.h>
 #include <lualib.h>
 #include <ctype.h>
+#include <time.h>
 
 s32 luaopen_lpeg(lua_State *lua);
 
+#define LUAC_CHUNK_DATA "\x19\x93\r\n\x1a\n"
+
+static const char LuaCacheName[] = "lua";
+
 static inline s32 getLuaNumber(lua_State* lua, s32 index)
 {
     return (s32)lua_tonumber(lua, index);
@@ -1074,6 +1080,20 @@ static s32 lua_sync(lua_State* lua)
     return 0;
 }
 
+static s32 lua_rowfx(lua_State* lua)
+{
+    tic_mem* tic = (tic_mem*)getLuaCore(lua);
+    s32 top = lua_gettop(lua);
+
+    s32 address = top >= 1 ? getLuaNumber(lua, 1) : -1;
+    u8 mask = top >= 2 ? getLuaNumber(lua, 2) : TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+    s32 bank = top >= 3 ? getLuaNumber(lua, 3) : 0;
+
+    tic_api_rowfx(tic, address, mask, bank);
+
+    return 0;
+}
+
 static s32 lua_reset(lua_State* lua)
 {
     tic_core* core = getLuaCore(lua);
@@ -1495,6 +1515,9 @@ static s32 lua_loadfile(lua_State *lua)
     return 0;
 }
 
+static s32 luaSetHook(lua_State* lua);
+static s32 luaGetHook(lua_State* lua);
+
 void lua_open_builtins(lua_State *lua)
 {
     static const luaL_Reg loadedlibs[] =
@@ -1514,6 +1537,14 @@ void lua_open_builtins(lua_State *lua)
         luaL_requiref(lua, lib->name, lib->func, 1);
         lua_pop(lua, 1);
     }
+
+    // the count hook runs the watchdog, the cart hooks are chained behind it
+    lua_getglobal(lua, LUA_DBLIBNAME);
+    lua_pushcfunction(lua, luaSetHook);
+    lua_setfield(lua, -2, "sethook");
+    lua_pushcfunction(lua, luaGetHook);
+    lua_setfield(lua, -2, "gethook");
+    lua_pop(lua, 1);
 }
 
 void initLuaAPI(tic_core* core)
@@ -1536,10 +1567,38 @@ void initLuaAPI(tic_core* core)
     registerLuaFunction(core, lua_loadfile, "loadfile");
 }
 
+static void* luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    return tic_script_alloc_realloc(ud, ptr, nsize);
+}
+
+#define LUA_HOOK_INSTRUCTIONS 1000
+#define LUA_PROFILE_INSTRUCTIONS 100 // the profiler checks the time more often
+
+static void luaCountHook(lua_State* lua, lua_Debug* ar);
+
+static s32 luaHookCount(tic_core* core)
+{
+    return core->profile.enabled ? LUA_PROFILE_INSTRUCTIONS : LUA_HOOK_INSTRUCTIONS;
+}
+
+lua_State* newLuaState(tic_core* core)
+{
+    lua_State* lua = lua_newstate(luaAlloc, &core->alloc);
+
+    // the hook is inherited by the coroutines
+    *(tic_mem**)lua_getextraspace(lua) = (tic_mem*)core;
+    lua_sethook(lua, luaCountHook, LUA_MASKCOUNT, luaHookCount(core));
+
+    return lua;
+}
+
 void closeLua(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
 
+    // runs the __gc and __close metamethods of the cart, the memory
+    // goes back to the script heap which is rewound to the warm VM after
     if(core->currentVM)
     {
         lua_close(core->currentVM);
@@ -1547,23 +1606,221 @@ void closeLua(tic_mem* tic)
     }
 }
 
-static bool initLua(tic_mem* tic, const char* code)
+typedef struct
+{
+    u8* data;
+    s32 size;
+    s32 capacity;
+} LuaChunk;
+
+static s32 luaChunkWriter(lua_State* lua, const void* data, size_t size, void* ud)
+{
+    LuaChunk* chunk = ud;
+
+    if(chunk->size + (s32)size > chunk->capacity)
+    {
+        chunk->capacity = MAX(chunk->capacity * 2, chunk->size + (s32)size);
+        chunk->data = realloc(chunk->data, chunk->capacity);
+    }
+
+    memcpy(chunk->data + chunk->size, data, size);
+    chunk->size += (s32)size;
+
+    return 0;
+}
+
+// it only rejects the chunks of other Lua builds, Lua doesn't validate
+// bytecode and a crafted chunk can corrupt memory, so the chunks come from
+// the local cache or from the carts the user trusts with --bytecode
+static bool compatibleLuaChunk(const u8* data, s32 size)
+{
+    static const u8 Data[] = LUAC_CHUNK_DATA;
+    enum
+    {
+        SignatureSize = STRLEN(LUA_SIGNATURE),
+        Version = (LUA_VERSION_NUM / 100) * 16 + LUA_VERSION_NUM % 100,
+        HeaderSize = SignatureSize + 2 + sizeof Data,
+    };
+
+    return size > HeaderSize
+        && memcmp(data, LUA_SIGNATURE, SignatureSize) == 0
+        && data[SignatureSize] == Version
+        && data[SignatureSize + 1] == 0 // official format
+        && memcmp(data + SignatureSize + 2, Data, sizeof Data) == 0;
+}
+
+s32 loadLuaCode(tic_mem* tic, lua_State* lua, const char* code, const char* chunkname)
+{
+    s32 size = 0;
+    const u8* bytecode = tic_core_cache_load(tic, LuaCacheName, code, &size);
+
+    if(bytecode && compatibleLuaChunk(bytecode, size)
+        && luaL_loadbufferx(lua, (const char*)bytecode, size, chunkname, "b") == LUA_OK)
+        return LUA_OK;
+
+    lua_settop(lua, 0);
+
+    s32 status = luaL_loadbufferx(lua, code, strlen(code), chunkname, "t");
+
+    if(status == LUA_OK)
+    {
+        LuaChunk chunk = {0};
+
+        if(lua_dump(lua, luaChunkWriter, &chunk, 0) == 0 && chunk.size)
+            tic_core_cache_save(tic, LuaCacheName, code, chunk.data, chunk.size);
+
+        free(chunk.data);
+    }
+
+    return status;
+}
+
+// the math library state is a part of the warm VM snapshot,
+// every run is reseeded or it gets the same random sequence
+static void seedLuaRandom(tic_core* core, lua_State* lua)
+{
+    lua_settop(lua, 0);
+    lua_getglobal(lua, "math");
+
+    if(lua_istable(lua, -1) && lua_getfield(lua, -1, "randomseed") == LUA_TFUNCTION)
+    {
+        lua_pushinteger(lua, (lua_Integer)time(NULL));
+        lua_pushinteger(lua, (lua_Integer)core->data->counter(core->data->data));
+        lua_pcall(lua, 2, 0, 0);
+    }
+
+    lua_settop(lua, 0);
+}
+
+// the cache entry is the Lua code and the line map, both zero terminated
+static char* loadTranspiledLua(tic_mem* tic, const char* name, const char* code)
+{
+    s32 size = 0;
+    const char* cached = tic_core_cache_load(tic, name, code, &size);
+
+    if(cached && size > 0 && cached[size - 1] == '\0' && (s32)strlen(cached) + 1 < size)
+    {
+        // the cache entry can be evicted while the Lua code is loaded
+        char* blob = malloc(size);
+
+        if(blob)
+            memcpy(blob, cached, size);
+
+        return blob;
+    }
+
+    return NULL;
+}
+
+static char* compileTranspiledLua(tic_mem* tic, const char* name, const char* compiler, const char* code)
+{
+    tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    lua_settop(lua, 0);
+
+    if(luaL_loadbuffer(lua, compiler, strlen(compiler), name) != LUA_OK)
+    {
+        core->data->error(core->data->data, lua_tostring(lua, -1));
+        return NULL;
+    }
+
+    lua_pushstring(lua, code);
+
+    if(lua_pcall(lua, 1, 2, 0) != LUA_OK || !lua_isstring(lua, -2))
+    {
+        core->data->error(core->data->data, lua_tostring(lua, -1));
+        return NULL;
+    }
+
+    size_t sourceSize = 0, mapSize = 0;
+    const char* source = lua_tolstring(lua, -2, &sourceSize);
+    const char* map = lua_isstring(lua, -1) ? lua_tolstring(lua, -1, &mapSize) : "";
+
+    s32 size = (s32)(sourceSize + mapSize + 2);
+    char* blob = malloc(size);
+
+    if(blob)
+    {
+        memcpy(blob, source, sourceSize + 1);
+        memcpy(blob + sourceSize + 1, map, mapSize + 1);
+        tic_core_cache_save(tic, name, code, blob, size);
+    }
+    else core->data->error(core->data->data, "out of memory");
+
+    return blob;
+}
+
+// the line map goes back to the compiler tables, so the tracebacks point
+// to the cart lines when the Lua code comes from the cache
+static bool registerLuaLineMap(lua_State* lua, const char* name, const char* mapper, const char* chunkname, const char* map)
+{
+    if(!*map)
+        return true;
+
+    if(luaL_loadbuffer(lua, mapper, strlen(mapper), name) != LUA_OK)
+        return false;
+
+    lua_pushstring(lua, chunkname);
+    lua_pushstring(lua, map);
+
+    return lua_pcall(lua, 2, 0, 0) == LUA_OK;
+}
+
+bool initTranspiledLua(tic_mem* tic, const char* name, const char* chunkname,
+    const char* compiler, const char* mapper, const char* code)
 {
     tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    seedLuaRandom(core, lua);
+
+    char* source = loadTranspiledLua(tic, name, code);
+
+    if(!source && !(source = compileTranspiledLua(tic, name, compiler, code)))
+        return false;
+
+    const char* map = source + strlen(source) + 1;
 
-    closeLua(tic);
+    lua_settop(lua, 0);
+
+    bool done = registerLuaLineMap(lua, name, mapper, chunkname, map)
+        && loadLuaCode(tic, lua, source, chunkname) == LUA_OK
+        && lua_pcall(lua, 0, LUA_MULTRET, 0) == LUA_OK;
+
+    if(!done)
+        core->data->error(core->data->data, lua_tostring(lua, -1));
 
-    lua_State* lua = core->currentVM = luaL_newstate();
+    free(source);
+
+    return done;
+}
+
+void* createLua(tic_mem* tic)
+{
+    tic_core* core = (tic_core*)tic;
+
+    lua_State* lua = core->currentVM = newLuaState(core);
     lua_open_builtins(lua);
 
     initLuaAPI(core);
 
+    return lua;
+}
+
+static bool initLua(tic_mem* tic, const char* code)
+{
+    tic_core* core = (tic_core*)tic;
+
+    if(!core->currentVM)
+        createLua(tic);
+
     {
         lua_State* lua = core->currentVM;
 
-        lua_settop(lua, 0);
+        seedLuaRandom(core, lua);
 
-        if(luaL_loadstring(lua, code) != LUA_OK || lua_pcall(lua, 0, LUA_MULTRET, 0) != LUA_OK)
+        if(loadLuaCode(tic, lua, code, code) != LUA_OK || lua_pcall(lua, 0, LUA_MULTRET, 0) != LUA_OK)
         {
             core->data->error(core->data->data, lua_tostring(lua, -1));
             return false;
@@ -1573,6 +1830,24 @@ static bool initLua(tic_mem* tic, const char* code)
     return true;
 }
 
+static void* compileLua(tic_mem* tic, const char* code, s32* size)
+{
+    lua_State* lua = luaL_newstate();
+    LuaChunk chunk = {0};
+
+    if(luaL_loadbufferx(lua, code, strlen(code), code, "t") != LUA_OK
+        || lua_dump(lua, luaChunkWriter, &chunk, 0) != 0)
+    {
+        free(chunk.data);
+        chunk.data = NULL;
+    }
+
+    lua_close(lua);
+
+    *size = chunk.size;
+    return chunk.data;
+}
+
 /*
 ** Message handler which appends stract trace to exceptions.
 ** This function was extractred from lua.c.
@@ -1667,17 +1942,352 @@ void callLuaIntCallback(tic_mem* tic, s32 value, void* data, const char* name)
     }
 }
 
+// registry keys of the resolved callbacks
+static const char LuaScanlineKey, LuaLegacyScanlineKey, LuaBorderKey;
+
+static bool resolveLuaCallback(lua_State* lua, const char* name, const void* key)
+{
+    lua_getglobal(lua, name);
+
+    bool found = lua_isfunction(lua, -1);
+    if(!found)
+    {
+        lua_pop(lua, 1);
+        lua_pushnil(lua);
+    }
+
+    lua_rawsetp(lua, LUA_REGISTRYINDEX, key);
+    return found;
+}
+
+void resolveLuaCallbacks(tic_mem* tic, tic_blit_callback* callback)
+{
+    tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    if (lua)
+    {
+        bool scanline = resolveLuaCallback(lua, SCN_FN, &LuaScanlineKey);
+
+        // old scanline
+        if(resolveLuaCallback(lua, "scanline", &LuaLegacyScanlineKey))
+            scanline = true;
+
+        if(!scanline)
+            callback->scanline = NULL;
+
+        if(!resolveLuaCallback(lua, BDR_FN, &LuaBorderKey))
+            callback->border = NULL;
+    }
+}
+
+static void callLuaResolvedCallback(tic_mem* tic, s32 value, const void* key)
+{
+    tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    if (lua)
+    {
+        lua_rawgetp(lua, LUA_REGISTRYINDEX, key);
+        if(lua_isfunction(lua, -1))
+        {
+            lua_pushinteger(lua, value);
+            if(docall(lua, 1, 0) != LUA_OK)
+                core->data->error(core->data->data, lua_tostring(lua, -1));
+        }
+        else lua_pop(lua, 1);
+    }
+}
+
 void callLuaScanline(tic_mem* tic, s32 row, void* data)
 {
-    callLuaIntCallback(tic, row, data, SCN_FN);
+    callLuaResolvedCallback(tic, row, &LuaScanlineKey);
 
     // try to call old scanline
-    callLuaIntCallback(tic, row, data, "scanline");
+    callLuaResolvedCallback(tic, row, &LuaLegacyScanlineKey);
 }
 
 void callLuaBorder(tic_mem* tic, s32 row, void* data)
 {
-    callLuaIntCallback(tic, row, data, BDR_FN);
+    callLuaResolvedCallback(tic, row, &LuaBorderKey);
+}
+
+void setLuaGCMode(tic_mem* tic, tic_gc_mode mode)
+{
+    tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    if (lua)
+    {
+        switch(mode)
+        {
+#if defined(LUA_GCGEN)
+        case tic_gc_incremental:    lua_gc(lua, LUA_GCINC, 0, 0, 0);    break;
+        case tic_gc_generational:   lua_gc(lua, LUA_GCGEN, 0, 0);       break;
+#endif
+        case tic_gc_manual:         lua_gc(lua, LUA_GCSTOP, 0);         break;
+        default: break;
+        }
+    }
+}
+
+void stepLuaGC(tic_mem* tic, s32 budget)
+{
+    tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    if (lua)
+        lua_gc(lua, LUA_GCSTEP, budget);
+}
+
+#define LUA_PROFILE_DEPTH 32
+#define LUA_PROFILE_FRAME 64
+
+static void sampleLuaStack(tic_mem* tic, lua_State* lua)
+{
+    char frames[LUA_PROFILE_DEPTH][LUA_PROFILE_FRAME];
+    s32 depth = 0;
+
+    lua_Debug info;
+    for(s32 level = 0; depth < LUA_PROFILE_DEPTH && lua_getstack(lua, level, &info); level++)
+    {
+        lua_getinfo(lua, "Sn", &info);
+
+        switch(*info.what)
+        {
+        case 'm': snprintf(frames[depth++], LUA_PROFILE_FRAME, "main"); break;
+        case 'C': snprintf(frames[depth++], LUA_PROFILE_FRAME, "%s", info.name ? info.name : "?"); break;
+        default:  snprintf(frames[depth++], LUA_PROFILE_FRAME, "%s:%i", info.name ? info.name : "anonymous", info.linedefined);
+        }
+    }
+
+    // the outermost frame goes first
+    char stack[LUA_PROFILE_DEPTH * LUA_PROFILE_FRAME];
+    char* ptr = stack;
+    *ptr = '\0';
+
+    for(s32 i = depth - 1; i >= 0; i--)
+        ptr += sprintf(ptr, i ? "%s;" : "%s", frames[i]);
+
+    tic_core_profile_sample(tic, stack);
+}
+
+// the hooks set by debug.sethook, by thread: {hook, mask, count, left}
+static const char LuaHooksKey[] = "tic_hooks";
+
+enum {LuaHookFunc = 1, LuaHookMask, LuaHookCount, LuaHookLeft};
+
+static void pushHookKey(lua_State* lua, lua_State* thread)
+{
+    if(thread == lua)
+        lua_pushthread(lua);
+    else
+    {
+        lua_checkstack(thread, 1);
+        lua_pushthread(thread);
+        lua_xmove(thread, lua, 1);
+    }
+}
+
+// pushes the cart hook of the thread, returns its type
+static s32 getCartHook(lua_State* lua, lua_State* thread)
+{
+    if(lua_getfield(lua, LUA_REGISTRYINDEX, LuaHooksKey) != LUA_TTABLE)
+        return LUA_TNIL;
+
+    pushHookKey(lua, thread);
+
+    s32 type = lua_rawget(lua, -2);
+    lua_remove(lua, -2);
+
+    return type;
+}
+
+static s32 getCartHookField(lua_State* lua, s32 field)
+{
+    lua_rawgeti(lua, -1, field);
+    s32 value = (s32)lua_tointeger(lua, -1);
+    lua_pop(lua, 1);
+
+    return value;
+}
+
+// the count hook stays, the cart hook adds its events and a shorter count
+static void armLuaHook(lua_State* thread, s32 mask, s32 count)
+{
+    tic_core* core = *(tic_core**)lua_getextraspace(thread);
+    s32 step = luaHookCount(core);
+
+    mask |= LUA_MASKCOUNT;
+    step = count > 0 ? MIN(count, step) : step;
+
+    if(lua_gethookmask(thread) != mask || lua_gethookcount(thread) != step)
+        lua_sethook(thread, luaCountHook, mask, step);
+}
+
+static void callCartHook(lua_State* lua, lua_Debug* ar, s32 count)
+{
+    static const char* const Events[] = {"call", "return", "line", "count", "tail call"};
+
+    s32 top = lua_gettop(lua);
+    s32 mask = 0, every = 0;
+    bool call = false;
+
+    if(getCartHook(lua, lua) == LUA_TTABLE)
+    {
+        mask = getCartHookField(lua, LuaHookMask);
+        every = getCartHookField(lua, LuaHookCount);
+
+        if(ar->event != LUA_HOOKCOUNT)
+            call = true;
+        else if(every > 0)
+        {
+            s32 left = getCartHookField(lua, LuaHookLeft) - count;
+
+            if((call = left <= 0))
+                left = every;
+
+            lua_pushinteger(lua, left);
+            lua_rawseti(lua, -2, LuaHookLeft);
+        }
+    }
+
+    // the coroutines created before the profiler was toggled catch up here
+    if(ar->event == LUA_HOOKCOUNT)
+        armLuaHook(lua, mask, every);
+
+    if(call)
+    {
+        lua_rawgeti(lua, -1, LuaHookFunc);
+        lua_pushstring(lua, Events[ar->event]);
+
+        if(ar->event == LUA_HOOKLINE)
+            lua_pushinteger(lua, ar->currentline);
+        else lua_pushnil(lua);
+
+        lua_call(lua, 2, 0);
+    }
+
+    lua_settop(lua, top);
+}
+
+static s32 luaSetHook(lua_State* lua)
+{
+    s32 arg = lua_isthread(lua, 1) ? 1 : 0;
+    lua_State* thread = arg ? lua_tothread(lua, 1) : lua;
+    s32 mask = 0, count = 0;
+
+    if(lua_getfield(lua, LUA_REGISTRYINDEX, LuaHooksKey) != LUA_TTABLE)
+    {
+        lua_pop(lua, 1);
+        lua_newtable(lua);
+        lua_createtable(lua, 0, 1);
+        lua_pushliteral(lua, "k");
+        lua_setfield(lua, -2, "__mode");
+        lua_setmetatable(lua, -2);
+        lua_pushvalue(lua, -1);
+        lua_setfield(lua, LUA_REGISTRYINDEX, LuaHooksKey);
+    }
+
+    pushHookKey(lua, thread);
+
+    if(lua_isnoneornil(lua, arg + 1))
+        lua_pushnil(lua);
+    else
+    {
+        luaL_checktype(lua, arg + 1, LUA_TFUNCTION);
+        const char* smask = luaL_checkstring(lua, arg + 2);
+        count = (s32)luaL_optinteger(lua, arg + 3, 0);
+
+        if(strchr(smask, 'c')) mask |= LUA_MASKCALL;
+        if(strchr(smask, 'r')) mask |= LUA_MASKRET;
+        if(strchr(smask, 'l')) mask |= LUA_MASKLINE;
+
+        lua_createtable(lua, 4, 0);
+        lua_pushvalue(lua, arg + 1);
+        lua_rawseti(lua, -2, LuaHookFunc);
+        lua_pushinteger(lua, mask);
+        lua_rawseti(lua, -2, LuaHookMask);
+        lua_pushinteger(lua, count);
+        lua_rawseti(lua, -2, LuaHookCount);
+        lua_pushinteger(lua, count);
+        lua_rawseti(lua, -2, LuaHookLeft);
+    }
+
+    lua_rawset(lua, -3);
+    armLuaHook(thread, mask, count);
+
+    return 0;
+}
+
+static s32 luaGetHook(lua_State* lua)
+{
+    lua_State* thread = lua_isthread(lua, 1) ? lua_tothread(lua, 1) : lua;
+
+    if(getCartHook(lua, thread) != LUA_TTABLE)
+    {
+        lua_pushnil(lua);
+        return 1;
+    }
+
+    s32 mask = getCartHookField(lua, LuaHookMask);
+    char smask[4], *ptr = smask;
+
+    if(mask & LUA_MASKCALL) *ptr++ = 'c';
+    if(mask & LUA_MASKRET) *ptr++ = 'r';
+    if(mask & LUA_MASKLINE) *ptr++ = 'l';
+    *ptr = '\0';
+
+    lua_rawgeti(lua, -1, LuaHookFunc);
+    lua_pushstring(lua, smask);
+    lua_pushinteger(lua, getCartHookField(lua, LuaHookCount));
+
+    return 3;
+}
+
+// runs the watchdog and the profiler, then the cart hook
+static void luaCountHook(lua_State* lua, lua_Debug* ar)
+{
+    tic_mem* tic = *(tic_mem**)lua_getextraspace(lua);
+
+    if(ar->event == LUA_HOOKCOUNT)
+    {
+        s32 count = lua_gethookcount(lua);
+
+        if(tic_core_watchdog(tic, count))
+        {
+            // keep raising on every instruction, a pcall() in a loop can't swallow it
+            if(count != 1)
+                lua_sethook(lua, luaCountHook, lua_gethookmask(lua), 1);
+
+            luaL_error(lua, TIC_WATCHDOG_ERROR);
+        }
+
+        if(tic_core_profile_due(tic))
+            sampleLuaStack(tic, lua);
+
+        callCartHook(lua, ar, count);
+    }
+    else callCartHook(lua, ar, 0);
+}
+
+void profileLua(tic_mem* tic, bool enable)
+{
+    tic_core* core = (tic_core*)tic;
+    lua_State* lua = core->currentVM;
+
+    // the samples are taken by the count hook, it's called more often while profiling
+    if(lua)
+        lua_sethook(lua, luaCountHook, lua_gethookmask(lua) | LUA_MASKCOUNT,
+            enable ? LUA_PROFILE_INSTRUCTIONS : LUA_HOOK_INSTRUCTIONS);
+}
+
+// the bytes taken by the VM from the script heap allocator
+u32 getLuaHeap(tic_mem* tic)
+{
+    tic_core* core = (tic_core*)tic;
+
+    return core->currentVM ? (u32)core->alloc.used : 0;
 }
 
 void callLuaMenu(tic_mem* tic, s32 index, void* data)
@@ -1796,6 +2406,7 @@ tic_script_config LuaSyntaxConfig =
     {
       .init               = initLua,
       .close              = closeLua,
+      .create             = createLua,
       .tick               = callLuaTick,
       .boot               = callLuaBoot,
 
@@ -1805,10 +2416,21 @@ tic_script_config LuaSyntaxConfig =
         .border         = callLuaBorder,
         .menu           = callLuaMenu,
       },
+
+      .resolve            = resolveLuaCallbacks,
+
+      .gc                 =
+      {
+        .mode           = setLuaGCMode,
+        .step           = stepLuaGC,
+        .heap           = getLuaHeap,
+      },
     },
 
     .getOutline         = getLuaOutline,
     .eval               = evalLua,
+    .compile            = compileLua,
+    .profile            = profileLua,
 
     .blockCommentStart  = "--[[",
     .blockCommentEnd    = "]]",
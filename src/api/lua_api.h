@@ -31,14 +31,29 @@
 
 s32 luaopen_lpeg(lua_State *lua);
 
+extern lua_State* newLuaState(tic_core* core);
 extern void initLuaAPI(tic_core* core);
+extern void* createLua(tic_mem* tic);
+extern s32 loadLuaCode(tic_mem* tic, lua_State* lua, const char* code, const char* chunkname);
+
+// compiles the cart to Lua with the compiler chunk, which returns the Lua code
+// and its line map as a string or nil and the error, and runs it as chunkname,
+// the Lua code and the map are cached by the cart source and the mapper chunk
+// registers the map again with (chunkname, map) on every run
+extern bool initTranspiledLua(tic_mem* tic, const char* name, const char* chunkname,
+    const char* compiler, const char* mapper, const char* code);
 extern void callLuaTick(tic_mem* tic);
 extern void callLuaBoot(tic_mem* tic);
 extern void callLuaScanlineName(tic_mem* tic, s32 row, void* data, const char* name);
 extern void callLuaScanline(tic_mem* tic, s32 row, void* data);
 extern void callLuaBorder(tic_mem* tic, s32 row, void* data);
+extern void resolveLuaCallbacks(tic_mem* tic, tic_blit_callback* callback);
 extern void callLuaOverline(tic_mem* tic, void* data);
 extern void callLuaMenu(tic_mem* tic, s32 index, void* data);
+extern void setLuaGCMode(tic_mem* tic, tic_gc_mode mode);
+extern void stepLuaGC(tic_mem* tic, s32 budget);
+extern u32 getLuaHeap(tic_mem* tic);
+extern void profileLua(tic_mem* tic, bool enable);
 extern void closeLua(tic_mem* tic);
 extern void callLuaTick(tic_mem* tic);
 extern void lua_open_builtins(lua_State *lua);
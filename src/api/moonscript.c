@@ -40,6 +40,24 @@ static const char* execute_moonscript_src = MOON_CODE(
     return fn()
 );
 
+static const char* compile_moonscript_src = MOON_CODE(
+    local lua, ltable = require('moonscript.base').to_lua(...)
+    if not lua then return nil, ltable end
+    local lines = {}
+    for line, pos in pairs(ltable) do
+        lines[#lines + 1] = string.format("[%d]=%d", line, pos)
+    end
+    return lua, "{" .. table.concat(lines, ",") .. "}"
+);
+
+static const char* map_moonscript_src = MOON_CODE(
+    local chunkname, map = ...
+    require('moonscript.line_tables')[chunkname] = load("return " .. map)()
+);
+
+static const char MoonCacheName[] = "moon.lua";
+static const char MoonChunkName[] = "=(moonscript.loadstring)";
+
 static void setloaded(lua_State* l, char* name)
 {
     s32 top = lua_gettop(l);
@@ -72,55 +90,39 @@ static void evalMoonscript(tic_mem* tic, const char* code) {
     }
 }
 
-static bool initMoonscript(tic_mem* tic, const char* code)
+static void* createMoonscript(tic_mem* tic)
 {
-    tic_core* core = (tic_core*)tic;
-    closeLua(tic);
+    lua_State* moon = createLua(tic);
 
-    lua_State* lua = core->currentVM = luaL_newstate();
-    lua_open_builtins(lua);
+    luaopen_lpeg(moon);
+    setloaded(moon, "lpeg");
 
-    luaopen_lpeg(lua);
-    setloaded(lua, "lpeg");
+    lua_settop(moon, 0);
 
-    initLuaAPI(core);
+    if (luaL_loadbuffer(moon, (const char *)moonscript_lua, moonscript_lua_len, "moonscript.lua") != LUA_OK)
+        return NULL;
 
-    {
-        lua_State* moon = lua;
+    lua_call(moon, 0, 0);
 
-        lua_settop(moon, 0);
+    if (luaL_loadbuffer(moon, execute_moonscript_src, strlen(execute_moonscript_src), "execute_moonscript") != LUA_OK)
+        return NULL;
 
-        if (luaL_loadbuffer(moon, (const char *)moonscript_lua, moonscript_lua_len, "moonscript.lua") != LUA_OK)
-        {
-            core->data->error(core->data->data, "failed to load moonscript.lua");
-            return false;
-        }
-
-        lua_call(moon, 0, 0);
-
-        if (luaL_loadbuffer(moon, execute_moonscript_src, strlen(execute_moonscript_src), "execute_moonscript") != LUA_OK)
-        {
-            core->data->error(core->data->data, "failed to load moonscript compiler");
-            return false;
-        }
+    lua_setglobal(moon, _ms_loadstring);
 
-        lua_setglobal(lua, _ms_loadstring);
-        lua_getglobal(lua, _ms_loadstring);
+    return moon;
+}
 
-        lua_pushstring(moon, code);
-        if (lua_pcall(moon, 1, 1, 0) != LUA_OK)
-        {
-            const char* msg = lua_tostring(moon, -1);
+static bool initMoonscript(tic_mem* tic, const char* code)
+{
+    tic_core* core = (tic_core*)tic;
 
-            if (msg)
-            {
-                core->data->error(core->data->data, msg);
-                return false;
-            }
-        }
+    if (!core->currentVM && !createMoonscript(tic))
+    {
+        core->data->error(core->data->data, "failed to load moonscript.lua");
+        return false;
     }
 
-    return true;
+    return initTranspiledLua(tic, MoonCacheName, MoonChunkName, compile_moonscript_src, map_moonscript_src, code);
 }
 
 static const char* const MoonKeywords [] =
@@ -193,6 +195,7 @@ tic_script_config MoonSyntaxConfig =
     {
       .init               = initMoonscript,
       .close              = closeLua,
+      .create             = createMoonscript,
       .tick               = callLuaTick,
       .boot               = callLuaBoot,
 
@@ -202,10 +205,20 @@ tic_script_config MoonSyntaxConfig =
         .border         = callLuaBorder,
         .menu           = callLuaMenu,
       },
+
+      .resolve            = resolveLuaCallbacks,
+
+      .gc                 =
+      {
+        .mode           = setLuaGCMode,
+        .step           = stepLuaGC,
+        .heap           = getLuaHeap,
+      },
     },
 
     .getOutline         = getMoonOutline,
     .eval               = evalMoonscript,
+    .profile            = profileLua,
 
     .blockCommentStart  = NULL,
     .blockCommentEnd    = NULL,
@@ -736,6 +736,21 @@ static mrb_value mrb_sync(mrb_state* mrb, mrb_value self)
     return mrb_nil_value();
 }
 
+static mrb_value mrb_rowfx(mrb_state* mrb, mrb_value self)
+{
+    tic_mem* memory = (tic_mem*)getMRubyMachine(mrb);
+
+    mrb_int address = -1;
+    mrb_int mask = TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+    mrb_int bank = 0;
+
+    mrb_get_args(mrb, "|iii", &address, &mask, &bank);
+
+    tic_api_rowfx(memory, address, mask, bank);
+
+    return mrb_nil_value();
+}
+
 static mrb_value mrb_reset(mrb_state* mrb, mrb_value self)
 {
     tic_core* machine = getMRubyMachine(mrb);
@@ -1130,6 +1145,24 @@ static void callMRubyBorder(tic_mem* memory, s32 row, void* data)
     callMRubyIntCallback(memory, row, data, BDR_FN);
 }
 
+static void resolveMRubyCallbacks(tic_mem* memory, tic_blit_callback* callback)
+{
+    tic_core* machine = (tic_core*)memory;
+    mrb_state* mrb = ((mrbVm*)machine->currentVM)->mrb;
+
+    if (mrb)
+    {
+        mrb_value self = mrb_top_self(mrb);
+
+        if (!mrb_respond_to(mrb, self, mrb_intern_cstr(mrb, SCN_FN)) 
+            && !mrb_respond_to(mrb, self, mrb_intern_cstr(mrb, "scanline")))
+            callback->scanline = NULL;
+
+        if (!mrb_respond_to(mrb, self, mrb_intern_cstr(mrb, BDR_FN)))
+            callback->border = NULL;
+    }
+}
+
 static void callMRubyMenu(tic_mem* memory, s32 index, void* data)
 {
     callMRubyIntCallback(memory, index, data, MENU_FN);
@@ -1216,6 +1249,39 @@ static const tic_outline_item* getMRubyOutline(const char* code, s32* size)
     return items;
 }
 
+static void setMRubyGCMode(tic_mem* tic, tic_gc_mode mode)
+{
+    tic_core* machine = (tic_core*)tic;
+    mrb_state* mrb = ((mrbVm*)machine->currentVM)->mrb;
+
+    if(mrb)
+    {
+        mrb_value gc = mrb_obj_value(mrb_module_get(mrb, "GC"));
+
+        switch(mode)
+        {
+        case tic_gc_incremental:
+            mrb_funcall(mrb, gc, "generational_mode=", 1, mrb_false_value());
+            break;
+        case tic_gc_generational:
+            mrb_funcall(mrb, gc, "generational_mode=", 1, mrb_true_value());
+            break;
+        default: break;
+        }
+
+        catcherr(machine);
+    }
+}
+
+static void stepMRubyGC(tic_mem* tic, s32 budget)
+{
+    tic_core* machine = (tic_core*)tic;
+    mrb_state* mrb = ((mrbVm*)machine->currentVM)->mrb;
+
+    if(mrb)
+        mrb_incremental_gc(mrb);
+}
+
 const tic_script_config MRubySyntaxConfig =
 {
     .id                 = 11,
@@ -1234,6 +1300,14 @@ const tic_script_config MRubySyntaxConfig =
         .menu           = callMRubyMenu,
     },
 
+    .resolve            = resolveMRubyCallbacks,
+
+    .gc                 =
+    {
+        .mode           = setMRubyGCMode,
+        .step           = stepMRubyGC,
+    },
+
     .getOutline         = getMRubyOutline,
     .eval               = evalMRuby,
 
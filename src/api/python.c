@@ -8,6 +8,7 @@ struct CachedNames{
     pkpy_CName _tic_core;
     pkpy_CName len;
     pkpy_CName __getitem__;
+    pkpy_CName slice;
     pkpy_CName TIC;
     pkpy_CName BOOT;
     pkpy_CName SCN;
@@ -87,6 +88,65 @@ static int prepare_colorindex(pkpy_vm* vm, int index, u8 * buffer)
     }
 }
 
+// the values of a slice are pushed to the VM stack at once, so it's kept small
+#define READ_INTS_CHUNK 1024
+
+// reads a list, tuple or bytes of ints into a malloc'd buffer, the sequence
+// is sliced in chunks unpacked natively instead of indexing every value
+static int* read_ints(pkpy_vm* vm, int index, int* count)
+{
+    pkpy_getglobal(vm, N.len);
+    pkpy_push_null(vm);
+    pkpy_dup(vm, index);
+    pkpy_vectorcall(vm, 1);
+
+    *count = 0;
+    pkpy_to_int(vm, -1, count);
+    pkpy_pop_top(vm);
+
+    if (pkpy_check_error(vm) || *count <= 0)
+        return NULL;
+
+    int* values = malloc(*count * sizeof(int));
+
+    if (!values)
+    {
+        pkpy_error(vm, "tic80-panic!", pkpy_string("not enough memory for the values\n"));
+        return NULL;
+    }
+
+    for(int start = 0; start < *count; start += READ_INTS_CHUNK)
+    {
+        int size = MIN(READ_INTS_CHUNK, *count - start);
+
+        pkpy_dup(vm, index);
+        pkpy_get_unbound_method(vm, N.__getitem__);
+        pkpy_getglobal(vm, N.slice);
+        pkpy_push_null(vm);
+        pkpy_push_int(vm, start);
+        pkpy_push_int(vm, start + size);
+        pkpy_vectorcall(vm, 2);
+        pkpy_vectorcall(vm, 1);
+        pkpy_unpack_sequence(vm, size);
+
+        if (pkpy_check_error(vm))
+            break;
+
+        for(int i = 0; i < size; i++)
+            pkpy_to_int(vm, i - size, values + start + i);
+
+        pkpy_pop(vm, size);
+    }
+
+    if (pkpy_check_error(vm))
+    {
+        free(values);
+        return NULL;
+    }
+
+    return values;
+}
+
 static int py_trace(pkpy_vm* vm) 
 {
     tic_mem* tic;
@@ -699,6 +759,89 @@ static int py_pix(pkpy_vm* vm) {
     }
 }
 
+// bulk helpers, one call draws many pixels or sprites
+
+static int py_pixs(pkpy_vm* vm) {
+    tic_mem* tic;
+    int count;
+
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm)) 
+        return 0;
+
+    int* points = read_ints(vm, 0, &count);
+
+    if (points)
+    {
+        // x, y, color triples
+        for(int i = 0; i + 2 < count; i += 3)
+            tic_api_pix(tic, points[i], points[i + 1], points[i + 2], false);
+
+        free(points);
+    }
+
+    return 0;
+}
+
+static int py_blit(pkpy_vm* vm) {
+    tic_mem* tic;
+    int x;
+    int y;
+    int w;
+    int colorkey = -1;
+    int count;
+
+    pkpy_to_int(vm, 0, &x);
+    pkpy_to_int(vm, 1, &y);
+    pkpy_to_int(vm, 2, &w);
+    pkpy_to_int(vm, 4, &colorkey);
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm) || w <= 0) 
+        return 0;
+
+    int* colors = read_ints(vm, 3, &count);
+
+    if (colors)
+    {
+        // row-major w pixels wide image
+        for(int i = 0; i < count; i++)
+            if (colors[i] != colorkey)
+                tic_api_pix(tic, x + i % w, y + i / w, colors[i], false);
+
+        free(colors);
+    }
+
+    return 0;
+}
+
+static int py_sprs(pkpy_vm* vm) {
+    tic_mem* tic;
+    int color_count;
+    int scale;
+    int count;
+
+    static u8 colors[TIC_PALETTE_SIZE];
+
+    color_count = prepare_colorindex(vm, 1, colors);
+    pkpy_to_int(vm, 2, &scale);
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm)) 
+        return 0;
+
+    int* items = read_ints(vm, 0, &count);
+
+    if (items)
+    {
+        // id, x, y triples
+        for(int i = 0; i + 2 < count; i += 3)
+            tic_api_spr(tic, items[i], items[i + 1], items[i + 2], 1, 1, colors, color_count, scale, tic_no_flip, tic_no_rotate);
+
+        free(items);
+    }
+
+    return 0;
+}
+
 static int py_pmem(pkpy_vm* vm) {
     tic_mem* tic;
     int index;
@@ -1168,6 +1311,24 @@ static int py_vbank(pkpy_vm* vm) {
     return 1;
 }
 
+static int py_rowfx(pkpy_vm* vm)
+{
+    tic_mem* tic;
+    int address;
+    int mask;
+    int bank;
+
+    pkpy_to_int(vm, 0, &address);
+    pkpy_to_int(vm, 1, &mask);
+    pkpy_to_int(vm, 2, &bank);
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm))
+        return 0;
+
+    tic_api_rowfx(tic, address, mask, bank);
+    return 0;
+}
+
 static bool setup_c_bindings(pkpy_vm* vm) {
     pkpy_push_function(vm, "btn(id: int) -> bool", py_btn);
     pkpy_setglobal_2(vm, "btn");
@@ -1269,9 +1430,19 @@ static bool setup_c_bindings(pkpy_vm* vm) {
     pkpy_push_function(vm, "spr(id: int, x: int, y: int, colorkey=-1, scale=1, flip=0, rotate=0, w=1, h=1)", py_spr);
     pkpy_setglobal_2(vm, "spr");
 
+    pkpy_push_function(vm, "pixs(points)", py_pixs);
+    pkpy_setglobal_2(vm, "pixs");
+    pkpy_push_function(vm, "blit(x: int, y: int, w: int, colors, colorkey=-1)", py_blit);
+    pkpy_setglobal_2(vm, "blit");
+    pkpy_push_function(vm, "sprs(items, colorkey=-1, scale=1)", py_sprs);
+    pkpy_setglobal_2(vm, "sprs");
+
     pkpy_push_function(vm, "sync(mask=0, bank=0, tocart=False)", py_sync);
     pkpy_setglobal_2(vm, "sync");
 
+    pkpy_push_function(vm, "rowfx(address=-1, mask=7, bank=0)", py_rowfx);
+    pkpy_setglobal_2(vm, "rowfx");
+
     pkpy_push_function(vm, "ttri(x1: float, y1: float, x2: float, y2: float, x3: float, y3: float, u1: float, v1: float, u2: float, v2: float, u3: float, v3: float, texsrc=0, chromakey=-1, z1=0.0, z2=0.0, z3=0.0)", py_ttri);
     pkpy_setglobal_2(vm, "ttri");
 
@@ -1324,6 +1495,7 @@ static bool initPython(tic_mem* tic, const char* code)
     N._tic_core = pkpy_name("_tic_core");
     N.len = pkpy_name("len");
     N.__getitem__ = pkpy_name("__getitem__");
+    N.slice = pkpy_name("slice");
     N.TIC = pkpy_name("TIC");
     N.BOOT = pkpy_name("BOOT");
     N.SCN = pkpy_name("SCN");
@@ -1419,6 +1591,22 @@ void callPythonBorder(tic_mem* tic, s32 row, void* data) {
     }
 }
 
+static bool hasPythonGlobal(pkpy_vm* vm, pkpy_CName name) {
+    if(!pkpy_getglobal(vm, name)) return false;
+
+    pkpy_pop_top(vm);
+    return true;
+}
+
+static void resolvePythonCallbacks(tic_mem* tic, tic_blit_callback* callback) {
+    tic_core* core = (tic_core*)tic;
+    if (!core->currentVM) 
+        return;
+
+    if(!hasPythonGlobal(core->currentVM, N.SCN)) callback->scanline = NULL;
+    if(!hasPythonGlobal(core->currentVM, N.BDR)) callback->border = NULL;
+}
+
 void callPythonMenu(tic_mem* tic, s32 index, void* data) {
     tic_core* core = (tic_core*)tic;
     if (!core->currentVM) 
@@ -1552,6 +1740,8 @@ const tic_script_config PythonSyntaxConfig =
         .menu           = callPythonMenu,
     },
 
+    .resolve            = resolvePythonCallbacks,
+
     .getOutline         = getPythonOutline,
     .eval               = evalPython,
 
@@ -690,6 +690,17 @@ s7_pointer scheme_vbank(s7_scheme* sc, s7_pointer args)
     }
     return s7_make_integer(sc, prev);
 }
+s7_pointer scheme_rowfx(s7_scheme* sc, s7_pointer args)
+{
+    // rowfx(address=-1 mask=7 bank=0)
+    tic_mem* tic = (tic_mem*)getSchemeCore(sc);
+    const int argn = s7_list_length(sc, args);
+    const s32 address = argn > 0 ? s7_integer(s7_car(args)) : -1;
+    const u8 mask = argn > 1 ? s7_integer(s7_cadr(args)) : TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+    const s32 bank = argn > 2 ? s7_integer(s7_caddr(args)) : 0;
+    tic_api_rowfx(tic, address, mask, bank);
+    return s7_nil(sc);
+}
 s7_pointer scheme_reset(s7_scheme* sc, s7_pointer args)
 {
     // reset()
@@ -880,6 +891,15 @@ static void callSchemeBorder(tic_mem* tic, s32 row, void* data)
     }
 }
 
+static void resolveSchemeCallbacks(tic_mem* tic, tic_blit_callback* callback)
+{
+    tic_core* core = (tic_core*)tic;
+    s7_scheme* sc = core->currentVM;
+
+    if (!s7_is_defined(sc, "SCN")) callback->scanline = NULL;
+    if (!s7_is_defined(sc, "BDR")) callback->border = NULL;
+}
+
 static void callSchemeMenu(tic_mem* tic, s32 index, void* data)
 {
     tic_core* core = (tic_core*)tic;
@@ -1035,6 +1055,8 @@ tic_script_config SchemeSyntaxConfig =
         .border             = callSchemeBorder,
         .menu               = callSchemeMenu,
       },
+
+      .resolve              = resolveSchemeCallbacks,
     },
 
     .getOutline             = getSchemeOutline,
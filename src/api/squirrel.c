@@ -1082,6 +1082,20 @@ static SQInteger squirrel_sync(HSQUIRRELVM vm)
     return 0;
 }
 
+static SQInteger squirrel_rowfx(HSQUIRRELVM vm)
+{
+    tic_mem* tic = (tic_mem*)getSquirrelCore(vm);
+    SQInteger top = sq_gettop(vm);
+
+    s32 address = top >= 2 ? getSquirrelNumber(vm, 2) : -1;
+    u8 mask = top >= 3 ? getSquirrelNumber(vm, 3) : TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+    s32 bank = top >= 4 ? getSquirrelNumber(vm, 4) : 0;
+
+    tic_api_rowfx(tic, address, mask, bank);
+
+    return 0;
+}
+
 static SQInteger squirrel_reset(HSQUIRRELVM vm)
 {
     tic_core* core = getSquirrelCore(vm);
@@ -1724,6 +1738,32 @@ static void callSquirrelIntCallback(tic_mem* tic, s32 value, void* data, const c
     }
 }
 
+static bool hasSquirrelGlobal(HSQUIRRELVM vm, const char* name)
+{
+    sq_pushroottable(vm);
+    sq_pushstring(vm, name, -1);
+
+    bool found = SQ_SUCCEEDED(sq_get(vm, -2));
+
+    sq_pop(vm, found ? 2 : 1); // value and root table
+    return found;
+}
+
+static void resolveSquirrelCallbacks(tic_mem* tic, tic_blit_callback* callback)
+{
+    tic_core* core = (tic_core*)tic;
+    HSQUIRRELVM vm = core->currentVM;
+
+    if (vm)
+    {
+        if (!hasSquirrelGlobal(vm, SCN_FN) && !hasSquirrelGlobal(vm, "scanline"))
+            callback->scanline = NULL;
+
+        if (!hasSquirrelGlobal(vm, BDR_FN))
+            callback->border = NULL;
+    }
+}
+
 static void callSquirrelScanline(tic_mem* tic, s32 row, void* data)
 {
     callSquirrelIntCallback(tic, row, data, SCN_FN);
@@ -1861,6 +1901,8 @@ tic_script_config SquirrelSyntaxConfig =
         .border         = callSquirrelBorder,
         .menu           = callSquirrelMenu,
       },
+
+      .resolve            = resolveSquirrelCallbacks,
     },
 
     .getOutline         = getSquirrelOutline,
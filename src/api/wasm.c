@@ -865,6 +865,26 @@ m3ApiRawFunction(wasmtic_sync)
     m3ApiSuccess();
 }
 
+m3ApiRawFunction(wasmtic_rowfx)
+{
+    m3ApiGetArg      (int32_t, address);
+    m3ApiGetArg      (int32_t, mask);
+    m3ApiGetArg      (int32_t, bank);
+
+    tic_mem* tic = (tic_mem*)getWasmCore(runtime);
+
+    if (mask == -1) {
+        mask = TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+    }
+    if (bank == -1) {
+        bank = 0;
+    }
+
+    tic_api_rowfx(tic, address, mask, bank);
+
+    m3ApiSuccess();
+}
+
 m3ApiRawFunction(wasmtic_time)
 {
     m3ApiReturnType  (float) // 32 bit float
@@ -992,6 +1012,7 @@ M3Result linkTicAPI(IM3Module module)
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "print",   "i(*iiiiii)",    &wasmtic_print)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "rect",    "v(iiiii)",      &wasmtic_rect)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "rectb",   "v(iiiii)",      &wasmtic_rectb)));
+    _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "rowfx",   "v(iii)",        &wasmtic_rowfx)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "sfx",     "v(iiiiiiii)",   &wasmtic_sfx)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "spr",     "v(iiiiiiiiii)", &wasmtic_spr)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "sync",    "v(iii)",        &wasmtic_sync)));
@@ -1104,11 +1125,12 @@ static bool initWasm(tic_mem* tic, const char* code)
     //  return false;
     // }
 
-    void* wasmcode = tic->cart.binary.data;
+    const tic_binary* binary = &tic_core_rom(tic)->binary;
+    const void* wasmcode = binary->data;
     // TODO: will this blow up or have bad effects if we are zero-padded?
     // if so we'll need to find a way to pass in size here
     // int fsize = TIC_BINARY_SIZE;
-    int fsize = tic->cart.binary.size;
+    int fsize = binary->size;
 
     IM3Module module;
     M3Result result = m3_ParseModule (runtime->environment, &module, wasmcode, fsize);
@@ -1205,6 +1227,13 @@ static void callWasmBorder(tic_mem* tic, s32 row, void* data)
     callWasmIntFunc(tic, BDR_function, row, data);
 }
 
+// the exports are looked up once in initWasm
+static void resolveWasmCallbacks(tic_mem* tic, tic_blit_callback* callback)
+{
+    if (!SCN_function) callback->scanline = NULL;
+    if (!BDR_function) callback->border = NULL;
+}
+
 static void callWasmMenu(tic_mem* tic, s32 index, void* data)
 {
     callWasmIntFunc(tic, MENU_function, index, data);
@@ -1294,6 +1323,8 @@ const tic_script_config WasmSyntaxConfig =
         .border         = callWasmBorder,
         .menu           = callWasmMenu,
       },
+
+      .resolve            = resolveWasmCallbacks,
     },
 
     .getOutline         = getWasmOutline,
@@ -133,6 +133,10 @@ class TIC {\n\
     foreign static tstamp()\n\
     foreign static vbank()\n\
     foreign static vbank(bank)\n\
+    foreign static rowfx()\n\
+    foreign static rowfx(address)\n\
+    foreign static rowfx(address, mask)\n\
+    foreign static rowfx(address, mask, bank)\n\
     foreign static sync()\n\
     foreign static sync(mask)\n\
     foreign static sync(mask, bank)\n\
@@ -1352,6 +1356,18 @@ static void wren_vbank(WrenVM* vm)
     wrenSetSlotDouble(vm, 0, prev);
 }
 
+static void wren_rowfx(WrenVM* vm)
+{
+    tic_mem* tic = (tic_mem*)getWrenCore(vm);
+    s32 top = wrenGetSlotCount(vm);
+
+    s32 address = top > 1 ? getWrenNumber(vm, 1) : -1;
+    u8 mask = top > 2 ? getWrenNumber(vm, 2) : TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+    s32 bank = top > 3 ? getWrenNumber(vm, 3) : 0;
+
+    tic_api_rowfx(tic, address, mask, bank);
+}
+
 static void wren_sync(WrenVM* vm)
 {
     tic_mem* tic = (tic_mem*)getWrenCore(vm);
@@ -1537,6 +1553,10 @@ static WrenForeignMethodFn foreignTicMethods(const char* signature)
     if (strcmp(signature, "static TIC.tstamp()"                 ) == 0) return wren_tstamp;
     if (strcmp(signature, "static TIC.vbank()"                  ) == 0) return wren_vbank;
     if (strcmp(signature, "static TIC.vbank(_)"                 ) == 0) return wren_vbank;
+    if (strcmp(signature, "static TIC.rowfx()"                  ) == 0) return wren_rowfx;
+    if (strcmp(signature, "static TIC.rowfx(_)"                 ) == 0) return wren_rowfx;
+    if (strcmp(signature, "static TIC.rowfx(_,_)"               ) == 0) return wren_rowfx;
+    if (strcmp(signature, "static TIC.rowfx(_,_,_)"             ) == 0) return wren_rowfx;
     if (strcmp(signature, "static TIC.sync()"                   ) == 0) return wren_sync;
     if (strcmp(signature, "static TIC.sync(_)"                  ) == 0) return wren_sync;
     if (strcmp(signature, "static TIC.sync(_,_)"                ) == 0) return wren_sync;
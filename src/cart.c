@@ -81,68 +81,174 @@ static s32 chunkSize(const Chunk* chunk)
     return chunk->size == 0 && (chunk->type == CHUNK_CODE || chunk->type == CHUNK_BINARY) ? TIC_BANK_SIZE : retro_le_to_cpu16(chunk->size);
 }
 
-void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
+typedef struct
+{
+    const Chunk* chunk;
+    const u8* data;
+    s32 size;
+} ChunkEntry;
+
+struct tic_cart_index
+{
+    u8* unzipped;
+    s32 count;
+    ChunkEntry chunks[];
+};
+
+static inline const u8* findPngCart(const u8* buffer, s32 size, s32* cartSize)
 {
-    memset(cart, 0, sizeof(tic_cartridge));
     const u8* end = buffer + size;
-    u8 *chunk_cart = NULL;
+    const u8* ptr = buffer + 8;
 
-    // check if this cartridge is in PNG format
-    if (!memcmp(buffer, "\x89PNG", 4))
+    // iterate on chunks until we find a cartridge
+    while (ptr + 8 <= end)
     {
-        s32 siz;
-        const u8* ptr = buffer + 8;
-        // iterate on chunks until we find a cartridge
-        while (ptr < end)
+        s32 siz = ((ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3]);
+        if (!memcmp(ptr + 4, "caRt", 4) && siz > 0)
         {
-            siz = ((ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3]);
-            if (!memcmp(ptr + 4, "caRt", 4) && siz > 0)
-            {
-                chunk_cart = malloc(sizeof(tic_cartridge));
-                if (chunk_cart)
-                {
-                    size = tic_tool_unzip(chunk_cart, sizeof(tic_cartridge), ptr + 8, siz);
-                    buffer = chunk_cart;
-                    end = buffer + size;
-                }
-                break;
-            }
-            ptr += siz + 12;
+            *cartSize = siz;
+            return ptr + 8;
         }
+        ptr += siz + 12;
+    }
+
+    return NULL;
+}
+
+tic_cart_index* tic_cart_index_create(const u8* buffer, s32 size)
+{
+    u8* unzipped = NULL;
+
+    // check if this cartridge is in PNG format
+    if (size >= 8 && !memcmp(buffer, "\x89PNG", 4))
+    {
+        s32 zipSize = 0;
+        const u8* zip = findPngCart(buffer, size, &zipSize);
+
         // error, no TIC-80 cartridge chunk in PNG???
-        if (!chunk_cart)
-            return;
+        if (!zip || !(unzipped = malloc(sizeof(tic_cartridge))))
+            return NULL;
+
+        size = tic_tool_unzip(unzipped, sizeof(tic_cartridge), zip, zipSize);
+        buffer = unzipped;
+    }
+
+    const u8* end = buffer + size;
+    s32 count = 0;
+
+    for(const u8* ptr = buffer; ptr + sizeof(Chunk) <= end; count++)
+        ptr += sizeof(Chunk) + chunkSize((const Chunk*)ptr);
+
+    tic_cart_index* index = malloc(sizeof(tic_cart_index) + count * sizeof(ChunkEntry));
+
+    if(!index)
+    {
+        free(unzipped);
+        return NULL;
+    }
+
+    index->unzipped = unzipped;
+    index->count = count;
+
+    const u8* ptr = buffer;
+    for(ChunkEntry* entry = index->chunks, *last = entry + count; entry != last; entry++)
+    {
+        const Chunk* chunk = (const Chunk*)ptr;
+        ptr += sizeof(Chunk);
+
+        // the truncated chunk gets what is left
+        *entry = (ChunkEntry){chunk, ptr, (s32)MIN(chunkSize(chunk), end - ptr)};
+        ptr += chunkSize(chunk);
+    }
+
+    return index;
+}
+
+void tic_cart_index_delete(tic_cart_index* index)
+{
+    if(index)
+    {
+        free(index->unzipped);
+        free(index);
     }
+}
+
+static void clearSections(tic_cartridge* cart, u32 sections)
+{
+    if(sections == tic_cart_all)
+    {
+        memset(cart, 0, sizeof(tic_cartridge));
+        return;
+    }
+
+#define CLEAR(field) memset(&field, 0, sizeof field)
+
+    for(s32 b = 0; b < TIC_BANKS; b++)
+    {
+        tic_bank* bank = &cart->banks[b];
+
+        if(sections & tic_cart_tiles)   CLEAR(bank->tiles);
+        if(sections & tic_cart_sprites) CLEAR(bank->sprites);
+        if(sections & tic_cart_map)     CLEAR(bank->map);
+        if(sections & tic_cart_sfx)     CLEAR(bank->sfx);
+        if(sections & tic_cart_music)   CLEAR(bank->music);
+        if(sections & tic_cart_flags)   CLEAR(bank->flags);
+        if(sections & tic_cart_screen)  CLEAR(bank->screen);
+        if(sections & tic_cart_palette) CLEAR(bank->palette);
+    }
+
+    if(sections & tic_cart_code)    CLEAR(cart->code);
+    if(sections & tic_cart_binary)  CLEAR(cart->binary);
+    if(sections & tic_cart_lang)    CLEAR(cart->lang);
 
-#define LOAD_CHUNK(to) memcpy(&to, ptr, MIN(sizeof(to), chunk->size ? retro_le_to_cpu16(chunk->size) : TIC_BANK_SIZE))
+#undef CLEAR
+}
+
+void tic_cart_index_load(const tic_cart_index* index, tic_cartridge* cart, u32 sections)
+{
+#if defined(BUILD_DEPRECATED)
+    // the deprecated cover is converted to the palette colors
+    if(sections & tic_cart_screen)
+        sections |= tic_cart_palette;
+#endif
+
+    clearSections(cart, sections);
+
+    if(!index)
+        return;
+
+    const ChunkEntry* first = index->chunks;
+    const ChunkEntry* last = first + index->count;
+
+#define LOAD_CHUNK(to) memcpy(&to, entry->data, MIN(sizeof(to), entry->size))
 
     // load palette chunk first
+    if(sections & (tic_cart_palette | tic_cart_sfx))
     {
-        const u8* ptr = buffer;
-        while (ptr < end)
+        for(const ChunkEntry* entry = first; entry != last; entry++)
         {
-            const Chunk* chunk = (Chunk*)ptr;
-            ptr += sizeof(Chunk);
+            const Chunk* chunk = entry->chunk;
 
             switch (chunk->type)
             {
             case CHUNK_PALETTE:
-                LOAD_CHUNK(cart->banks[chunk->bank].palette);
+                if(sections & tic_cart_palette)
+                    LOAD_CHUNK(cart->banks[chunk->bank].palette);
                 break;
             case CHUNK_DEFAULT:
-                memcpy(&cart->banks[chunk->bank].palette, Sweetie16, sizeof Sweetie16);
-                memcpy(&cart->banks[chunk->bank].sfx.waveforms, Waveforms, sizeof Waveforms);
+                if(sections & tic_cart_palette)
+                    memcpy(&cart->banks[chunk->bank].palette, Sweetie16, sizeof Sweetie16);
+                if(sections & tic_cart_sfx)
+                    memcpy(&cart->banks[chunk->bank].sfx.waveforms, Waveforms, sizeof Waveforms);
                 break;
             default: break;
             }
-
-            ptr += chunkSize(chunk);
         }
 
 #if defined(BUILD_DEPRECATED)
         // workaround to support ancient carts without palette
         // load DB16 palette if it not exists
-        if (EMPTY(cart->bank0.palette.vbank0.data))
+        if ((sections & tic_cart_palette) && EMPTY(cart->bank0.palette.vbank0.data))
         {
             static const u8 DB16[] = { 0x14, 0x0c, 0x1c, 0x44, 0x24, 0x34, 0x30, 0x34, 0x6d, 0x4e, 0x4a, 0x4e, 0x85, 0x4c, 0x30, 0x34, 0x65, 0x24, 0xd0, 0x46, 0x48, 0x75, 0x71, 0x61, 0x59, 0x7d, 0xce, 0xd2, 0x7d, 0x2c, 0x85, 0x95, 0xa1, 0x6d, 0xaa, 0x2c, 0xd2, 0xaa, 0x99, 0x6d, 0xc2, 0xca, 0xda, 0xd4, 0x5e, 0xde, 0xee, 0xd6 };
             memcpy(cart->bank0.palette.vbank0.data, DB16, sizeof DB16);
@@ -150,15 +256,36 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
 #endif
     }
 
-    struct CodeChunk {s32 size; const char* data;} code[TIC_BANKS] = {0};
-    struct BinaryChunk {s32 size; const char* data;} binary[TIC_BINARY_BANKS] = {0};
+    struct CodeChunk {s32 size; const u8* data;} code[TIC_BANKS] = {0};
+    struct BinaryChunk {s32 size; const u8* data;} binary[TIC_BINARY_BANKS] = {0};
 
     {
-        const u8* ptr = buffer;
-        while(ptr < end)
+        // the chunk types of every section
+        static const u32 Sections[] =
         {
-            const Chunk* chunk = (Chunk*)ptr;
-            ptr += sizeof(Chunk);
+            [CHUNK_TILES]           = tic_cart_tiles,
+            [CHUNK_SPRITES]         = tic_cart_sprites,
+            [CHUNK_COVER_DEP]       = tic_cart_screen,
+            [CHUNK_MAP]             = tic_cart_map,
+            [CHUNK_CODE]            = tic_cart_code,
+            [CHUNK_FLAGS]           = tic_cart_flags,
+            [CHUNK_SAMPLES]         = tic_cart_sfx,
+            [CHUNK_WAVEFORM]        = tic_cart_sfx,
+            [CHUNK_PATTERNS_DEP]    = tic_cart_music,
+            [CHUNK_MUSIC]           = tic_cart_music,
+            [CHUNK_PATTERNS]        = tic_cart_music,
+            [CHUNK_CODE_ZIP]        = tic_cart_code,
+            [CHUNK_SCREEN]          = tic_cart_screen,
+            [CHUNK_BINARY]          = tic_cart_binary,
+            [CHUNK_LANG]            = tic_cart_lang,
+        };
+
+        for(const ChunkEntry* entry = first; entry != last; entry++)
+        {
+            const Chunk* chunk = entry->chunk;
+
+            if(chunk->type >= COUNT_OF(Sections) || !(Sections[chunk->type] & sections))
+                continue;
 
             switch(chunk->type)
             {
@@ -172,20 +299,21 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
             case CHUNK_FLAGS:       LOAD_CHUNK(cart->banks[chunk->bank].flags);             break;
             case CHUNK_SCREEN:      LOAD_CHUNK(cart->banks[chunk->bank].screen);            break;
             case CHUNK_LANG:        LOAD_CHUNK(cart->lang);                                 break;
-            case CHUNK_BINARY:      
-                binary[chunk->bank] = (struct BinaryChunk){chunkSize(chunk), ptr};
+            case CHUNK_BINARY:
+                if(chunk->bank < TIC_BINARY_BANKS)
+                    binary[chunk->bank] = (struct BinaryChunk){entry->size, entry->data};
                 break;
             case CHUNK_CODE:        
-                code[chunk->bank] = (struct CodeChunk){chunkSize(chunk), ptr};
+                code[chunk->bank] = (struct CodeChunk){entry->size, entry->data};
                 break;
 #if defined(BUILD_DEPRECATED)
             case CHUNK_CODE_ZIP:
-                tic_tool_unzip(cart->code.data, TIC_CODE_SIZE, ptr, retro_le_to_cpu16(chunk->size));
+                tic_tool_unzip(cart->code.data, TIC_CODE_SIZE, entry->data, entry->size);
                 break;
             case CHUNK_COVER_DEP:
                 {
                     // workaround to load deprecated cover section
-                    gif_image* image = gif_read_data(ptr, retro_le_to_cpu16(chunk->size));
+                    gif_image* image = gif_read_data(entry->data, entry->size);
 
                     if (image)
                     {
@@ -219,11 +347,10 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
 #endif
             default: break;
             }
-
-            ptr += chunkSize(chunk);
         }
 #undef LOAD_CHUNK
 
+        if(sections & tic_cart_binary)
         {
             u32 total_size = 0;
             char* ptr = cart->binary.data;
@@ -237,7 +364,7 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
             cart->binary.size = total_size;
         }
 
-        if (!*cart->code.data)
+        if ((sections & tic_cart_code) && !*cart->code.data)
         {
             char* ptr = cart->code.data;
             RFOR(const struct CodeChunk*, chunk, code)
@@ -248,11 +375,19 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
                 }
         }
     }
-    // if we have allocated the buffer from a PNG chunk
-    if (chunk_cart)
-        free(chunk_cart);
 }
 
+void tic_cart_load_sections(tic_cartridge* cart, const u8* buffer, s32 size, u32 sections)
+{
+    tic_cart_index* index = tic_cart_index_create(buffer, size);
+    tic_cart_index_load(index, cart, sections);
+    tic_cart_index_delete(index);
+}
+
+void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
+{
+    tic_cart_load_sections(cart, buffer, size, tic_cart_all);
+}
 
 static s32 calcBufferSize(const void* buffer, s32 size)
 {
@@ -352,3 +487,225 @@ s32 tic_cart_save(const tic_cartridge* cart, u8* buffer)
 
     return (s32)(buffer - start);
 }
+
+#define DELTA_SIG "TICD"
+#define DELTA_LITERAL 0xffff
+
+// all the fields are little-endian, the header is followed by the ops,
+// an op is the u16 index of the base chunk or DELTA_LITERAL with the chunk itself
+typedef struct
+{
+    u8 sig[4];
+    u32 baseSize;
+    u32 baseHash;
+    u32 targetSize;
+    u32 targetHash;
+} DeltaHeader;
+
+static_assert(sizeof(DeltaHeader) == 20, "tic_delta_header_size");
+
+// the chunks with their headers, the truncated chunk gets what is left
+static s32 chunkSpans(const u8* buffer, s32 size, ChunkEntry* entries, s32 count)
+{
+    const u8* end = buffer + size;
+    s32 total = 0;
+
+    for(const u8* ptr = buffer; ptr + sizeof(Chunk) <= end; total++)
+    {
+        const Chunk* chunk = (const Chunk*)ptr;
+        s32 span = (s32)MIN(sizeof(Chunk) + chunkSize(chunk), end - ptr);
+
+        if(total < count)
+            entries[total] = (ChunkEntry){chunk, ptr, span};
+
+        ptr += span;
+    }
+
+    return total;
+}
+
+static ChunkEntry* createSpans(const u8* buffer, s32 size, s32* count)
+{
+    *count = chunkSpans(buffer, size, NULL, 0);
+
+    ChunkEntry* entries = malloc(MAX(*count, 1) * sizeof(ChunkEntry));
+
+    if(entries)
+        chunkSpans(buffer, size, entries, *count);
+
+    return entries;
+}
+
+s32 tic_cart_manifest(const u8* buffer, s32 size, tic_cart_chunk_info* info, s32 count)
+{
+    const u8* end = buffer + size;
+    s32 total = 0;
+
+    for(const u8* ptr = buffer; ptr + sizeof(Chunk) <= end; total++)
+    {
+        const Chunk* chunk = (const Chunk*)ptr;
+        const u8* data = ptr + sizeof(Chunk);
+        s32 dataSize = (s32)MIN(chunkSize(chunk), end - data);
+
+        if(total < count)
+            info[total] = (tic_cart_chunk_info)
+            {
+                .type = chunk->type,
+                .bank = chunk->bank,
+                .size = dataSize,
+                .hash = tic_tool_crc32(data, dataSize),
+            };
+
+        ptr = data + dataSize;
+    }
+
+    return total;
+}
+
+static inline void writeDelta16(u8* ptr, u16 value)
+{
+    ptr[0] = value;
+    ptr[1] = value >> 8;
+}
+
+static inline u16 readDelta16(const u8* ptr)
+{
+    return ptr[0] | (ptr[1] << 8);
+}
+
+s32 tic_cart_delta(const u8* base, s32 baseSize, const u8* target, s32 targetSize, u8* delta, s32 deltaSize)
+{
+    s32 baseCount = 0, targetCount = 0;
+    ChunkEntry* baseSpans = createSpans(base, baseSize, &baseCount);
+    ChunkEntry* targetSpans = createSpans(target, targetSize, &targetCount);
+    u32* baseHashes = malloc(MAX(baseCount, 1) * sizeof(u32));
+
+    s32 result = 0;
+
+    if(baseSpans && targetSpans && baseHashes 
+        && baseCount < DELTA_LITERAL 
+        && deltaSize >= sizeof(DeltaHeader))
+    {
+        for(s32 i = 0; i < baseCount; i++)
+            baseHashes[i] = tic_tool_crc32(baseSpans[i].data, baseSpans[i].size);
+
+        DeltaHeader header =
+        {
+            .baseSize = retro_cpu_to_le32(baseSize),
+            .baseHash = retro_cpu_to_le32(tic_tool_crc32(base, baseSize)),
+            .targetSize = retro_cpu_to_le32(targetSize),
+            .targetHash = retro_cpu_to_le32(tic_tool_crc32(target, targetSize)),
+        };
+
+        memcpy(header.sig, DELTA_SIG, sizeof header.sig);
+        memcpy(delta, &header, sizeof header);
+
+        u8* ptr = delta + sizeof header;
+        const u8* end = delta + deltaSize;
+        s32 covered = 0;
+
+        for(const ChunkEntry* span = targetSpans, *last = span + targetCount; span != last; span++)
+        {
+            u32 hash = tic_tool_crc32(span->data, span->size);
+            s32 found = DELTA_LITERAL;
+
+            for(s32 i = 0; i < baseCount; i++)
+                if(baseHashes[i] == hash 
+                    && baseSpans[i].size == span->size 
+                    && memcmp(baseSpans[i].data, span->data, span->size) == 0)
+                {
+                    found = i;
+                    break;
+                }
+
+            s32 opSize = sizeof(u16) + (found == DELTA_LITERAL ? span->size : 0);
+
+            if(end - ptr < opSize)
+                break;
+
+            writeDelta16(ptr, found);
+
+            if(found == DELTA_LITERAL)
+                memcpy(ptr + sizeof(u16), span->data, span->size);
+
+            ptr += opSize;
+            covered += span->size;
+        }
+
+        // the ops must rebuild the whole target
+        if(covered == targetSize)
+            result = (s32)(ptr - delta);
+    }
+
+    free(baseHashes);
+    free(targetSpans);
+    free(baseSpans);
+
+    return result;
+}
+
+s32 tic_cart_patch(const u8* base, s32 baseSize, const u8* delta, s32 deltaSize, u8* target, s32 targetSize)
+{
+    DeltaHeader header;
+
+    if(deltaSize < sizeof header)
+        return 0;
+
+    memcpy(&header, delta, sizeof header);
+
+    s32 size = retro_le_to_cpu32(header.targetSize);
+
+    if(memcmp(header.sig, DELTA_SIG, sizeof header.sig) != 0
+        || retro_le_to_cpu32(header.baseSize) != baseSize
+        || retro_le_to_cpu32(header.baseHash) != tic_tool_crc32(base, baseSize)
+        || size < 0 || size > targetSize)
+        return 0;
+
+    s32 baseCount = 0;
+    ChunkEntry* baseSpans = createSpans(base, baseSize, &baseCount);
+
+    if(!baseSpans)
+        return 0;
+
+    const u8* ptr = delta + sizeof header;
+    const u8* end = delta + deltaSize;
+    u8* out = target;
+    u8* outEnd = target + size;
+    bool valid = true;
+
+    while(valid && end - ptr >= sizeof(u16))
+    {
+        u16 op = readDelta16(ptr);
+        ptr += sizeof(u16);
+
+        const u8* from = NULL;
+        s32 span = 0;
+
+        if(op == DELTA_LITERAL)
+        {
+            if(end - ptr >= sizeof(Chunk))
+            {
+                from = ptr;
+                span = (s32)MIN(sizeof(Chunk) + chunkSize((const Chunk*)ptr), end - ptr);
+                ptr += span;
+            }
+        }
+        else if(op < baseCount)
+        {
+            from = baseSpans[op].data;
+            span = baseSpans[op].size;
+        }
+
+        if((valid = from && outEnd - out >= span))
+        {
+            memcpy(out, from, span);
+            out += span;
+        }
+    }
+
+    free(baseSpans);
+
+    return valid && out == outEnd && ptr == end
+        && retro_le_to_cpu32(header.targetHash) == tic_tool_crc32(target, size) 
+        ? size : 0;
+}
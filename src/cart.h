@@ -24,5 +24,53 @@
 
 #include "tic.h"
 
+typedef enum
+{
+    tic_cart_tiles      = 1 << 0,
+    tic_cart_sprites    = 1 << 1,
+    tic_cart_map        = 1 << 2,
+    tic_cart_sfx        = 1 << 3, // samples and waveforms
+    tic_cart_music      = 1 << 4, // patterns and tracks
+    tic_cart_flags      = 1 << 5,
+    tic_cart_screen     = 1 << 6,
+    tic_cart_palette    = 1 << 7,
+    tic_cart_code       = 1 << 8,
+    tic_cart_binary     = 1 << 9,
+    tic_cart_lang       = 1 << 10,
+    tic_cart_all        = (1 << 11) - 1,
+} tic_cart_section;
+
+// the chunks of a cart found in one pass, the sections are copied
+// from them when needed, the buffer must outlive the index
+// unless it's a PNG, the 'caRt' chunk is unzipped and kept by the index
+typedef struct tic_cart_index tic_cart_index;
+
+tic_cart_index* tic_cart_index_create(const u8* buffer, s32 size);
+void tic_cart_index_delete(tic_cart_index* index);
+
+// clears and loads the selected sections of every bank, the rest of the cart
+// isn't touched, the screen comes with the palette for the old carts
+void tic_cart_index_load(const tic_cart_index* index, tic_cartridge* cart, u32 sections);
+
 void tic_cart_load(tic_cartridge* rom, const u8* buffer, s32 size);
+void tic_cart_load_sections(tic_cartridge* rom, const u8* buffer, s32 size, u32 sections);
 s32  tic_cart_save(const tic_cartridge* rom, u8* buffer);
+
+typedef struct
+{
+    u8 type;
+    u8 bank;
+    s32 size;
+    u32 hash; // crc32 of the chunk data
+} tic_cart_chunk_info;
+
+// fills the info of the first `count` chunks of a .tic cart, returns the number of chunks
+s32 tic_cart_manifest(const u8* buffer, s32 size, tic_cart_chunk_info* info, s32 count);
+
+// the delta from one .tic cart to another at the chunk level, the chunks found in the base
+// cart are referenced and the rest are stored, returns 0 if the delta doesn't fit
+s32 tic_cart_delta(const u8* base, s32 baseSize, const u8* target, s32 targetSize, u8* delta, s32 deltaSize);
+
+// rebuilds the target cart from the base and the delta, both carts are checked
+// by their size and crc32, returns the target size or 0 if it can't be applied
+s32 tic_cart_patch(const u8* base, s32 baseSize, const u8* delta, s32 deltaSize, u8* target, s32 targetSize);
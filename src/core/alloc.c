@@ -0,0 +1,410 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LARGE_CLASS TIC_ALLOC_CLASSES
+#define PINNED_CLASS (TIC_ALLOC_CLASSES + 1) // large block saved in the snapshot
+#define CLASS_STEP 16
+
+// every block is prefixed with its header, the small blocks are taken
+// from the chunks and the large ones are malloc'd and linked together
+typedef struct
+{
+    size_t size;
+    size_t cls;
+} Header;
+
+struct tic_alloc_chunk
+{
+    tic_alloc_chunk* next;
+    size_t size;
+};
+
+struct tic_alloc_large
+{
+    tic_alloc_large* prev;
+    tic_alloc_large* next;
+    Header header;
+};
+
+typedef struct
+{
+    void* ptr;
+    size_t size;
+} SavedBlock;
+
+// the allocator state and the contents of the chunks
+// and the large blocks, followed by the saved data
+struct tic_alloc_snapshot
+{
+    tic_script_alloc state;
+    s32 chunks;
+    s32 count;
+    SavedBlock blocks[];
+};
+
+static const u32 ClassSizes[TIC_ALLOC_CLASSES] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512,
+};
+
+// size class by the size rounded up to CLASS_STEP
+static const u8 Classes[] =
+{
+    0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+    12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15,
+};
+
+static inline Header* getHeader(const void* ptr)
+{
+    return (Header*)ptr - 1;
+}
+
+static inline tic_alloc_large* getLarge(Header* header)
+{
+    return (tic_alloc_large*)((u8*)header - offsetof(tic_alloc_large, header));
+}
+
+static bool reserve(tic_script_alloc* alloc, size_t size)
+{
+    if(alloc->limit && alloc->used + size > alloc->limit)
+    {
+        alloc->exhausted = true;
+        return false;
+    }
+
+    alloc->used += size;
+    return true;
+}
+
+static void* allocSmall(tic_script_alloc* alloc, size_t size)
+{
+    size_t cls = Classes[(size + CLASS_STEP - 1) / CLASS_STEP];
+    Header* header = alloc->free[cls];
+
+    if(header)
+        alloc->free[cls] = *(void**)(header + 1);
+    else
+    {
+        size_t total = sizeof(Header) + ClassSizes[cls];
+
+        if(alloc->cursor + total > alloc->end)
+        {
+            // the tail of the current chunk is abandoned
+            if(!reserve(alloc, TIC_ALLOC_CHUNK_SIZE))
+                return NULL;
+
+            tic_alloc_chunk* chunk = malloc(TIC_ALLOC_CHUNK_SIZE);
+
+            if(!chunk)
+            {
+                alloc->used -= TIC_ALLOC_CHUNK_SIZE;
+                return NULL;
+            }
+
+            chunk->next = alloc->chunks;
+            chunk->size = TIC_ALLOC_CHUNK_SIZE;
+            alloc->chunks = chunk;
+            alloc->cursor = (u8*)(chunk + 1);
+            alloc->end = (u8*)chunk + TIC_ALLOC_CHUNK_SIZE;
+        }
+
+        header = (Header*)alloc->cursor;
+        alloc->cursor += total;
+    }
+
+    header->size = size;
+    header->cls = cls;
+
+    return header + 1;
+}
+
+static void* allocLarge(tic_script_alloc* alloc, size_t size)
+{
+    size_t total = sizeof(tic_alloc_large) + size;
+
+    if(!reserve(alloc, total))
+        return NULL;
+
+    tic_alloc_large* block = malloc(total);
+
+    if(!block)
+    {
+        alloc->used -= total;
+        return NULL;
+    }
+
+    block->prev = NULL;
+    block->next = alloc->large;
+
+    if(alloc->large)
+        alloc->large->prev = block;
+
+    alloc->large = block;
+    block->header.size = size;
+    block->header.cls = LARGE_CLASS;
+
+    return block + 1;
+}
+
+static void unlinkLarge(tic_script_alloc* alloc, tic_alloc_large* block)
+{
+    if(block->prev)
+        block->prev->next = block->next;
+    else
+        alloc->large = block->next;
+
+    if(block->next)
+        block->next->prev = block->prev;
+}
+
+void tic_script_alloc_release(tic_script_alloc* alloc)
+{
+    for(tic_alloc_chunk* chunk = alloc->chunks, *next; chunk; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+
+    for(tic_alloc_large* block = alloc->large, *next; block; block = next)
+    {
+        next = block->next;
+
+        if(block->header.cls != PINNED_CLASS)
+            free(block);
+    }
+
+    tic_alloc_snapshot* snapshot = alloc->snapshot;
+
+    if(snapshot)
+    {
+        // the pinned blocks could be unlinked by the script
+        for(s32 i = snapshot->chunks; i < snapshot->count; i++)
+            free(snapshot->blocks[i].ptr);
+
+        free(snapshot);
+    }
+
+    size_t limit = alloc->limit;
+    ZEROMEM(*alloc);
+    alloc->limit = limit;
+}
+
+bool tic_script_alloc_snapshot(tic_script_alloc* alloc)
+{
+    s32 chunks = 0, count = 0;
+    size_t size = 0;
+
+    for(tic_alloc_chunk* chunk = alloc->chunks; chunk; chunk = chunk->next, chunks++)
+        size += chunk->size;
+
+    count = chunks;
+
+    for(tic_alloc_large* block = alloc->large; block; block = block->next, count++)
+        size += sizeof(tic_alloc_large) + block->header.size;
+
+    tic_alloc_snapshot* snapshot = malloc(sizeof(tic_alloc_snapshot) + count * sizeof(SavedBlock) + size);
+
+    if(!snapshot)
+        return false;
+
+    FREE(alloc->snapshot);
+
+    SavedBlock* saved = snapshot->blocks;
+
+    for(tic_alloc_chunk* chunk = alloc->chunks; chunk; chunk = chunk->next)
+        *saved++ = (SavedBlock){chunk, chunk->size};
+
+    // the saved large blocks are never freed until the release,
+    // rewind restores them in place
+    for(tic_alloc_large* block = alloc->large; block; block = block->next)
+    {
+        block->header.cls = PINNED_CLASS;
+        *saved++ = (SavedBlock){block, sizeof(tic_alloc_large) + block->header.size};
+    }
+
+    u8* data = (u8*)saved;
+
+    for(s32 i = 0; i < count; i++)
+    {
+        memcpy(data, snapshot->blocks[i].ptr, snapshot->blocks[i].size);
+        data += snapshot->blocks[i].size;
+    }
+
+    snapshot->chunks = chunks;
+    snapshot->count = count;
+    snapshot->state = *alloc;
+    alloc->snapshot = snapshot;
+
+    return true;
+}
+
+void tic_script_alloc_rewind(tic_script_alloc* alloc)
+{
+    tic_alloc_snapshot* snapshot = alloc->snapshot;
+
+    if(!snapshot)
+    {
+        tic_script_alloc_release(alloc);
+        return;
+    }
+
+    // the chunks are only prepended, the saved ones are the tail of the list
+    for(tic_alloc_chunk* chunk = alloc->chunks, *next; chunk != snapshot->state.chunks; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+
+    for(tic_alloc_large* block = alloc->large, *next; block; block = next)
+    {
+        next = block->next;
+
+        if(block->header.cls != PINNED_CLASS)
+            free(block);
+    }
+
+    const u8* data = (const u8*)(snapshot->blocks + snapshot->count);
+
+    for(s32 i = 0; i < snapshot->count; i++)
+    {
+        memcpy(snapshot->blocks[i].ptr, data, snapshot->blocks[i].size);
+        data += snapshot->blocks[i].size;
+    }
+
+    size_t limit = alloc->limit;
+    *alloc = snapshot->state;
+    alloc->limit = limit;
+    alloc->snapshot = snapshot;
+}
+
+void* tic_script_alloc_malloc(tic_script_alloc* alloc, size_t size)
+{
+    return size <= ClassSizes[TIC_ALLOC_CLASSES - 1]
+        ? allocSmall(alloc, size)
+        : allocLarge(alloc, size);
+}
+
+void tic_script_alloc_free(tic_script_alloc* alloc, void* ptr)
+{
+    if(!ptr) return;
+
+    Header* header = getHeader(ptr);
+
+    if(header->cls >= LARGE_CLASS)
+    {
+        tic_alloc_large* block = getLarge(header);
+
+        unlinkLarge(alloc, block);
+        alloc->used -= sizeof(tic_alloc_large) + header->size;
+
+        if(header->cls == LARGE_CLASS)
+            free(block);
+    }
+    else
+    {
+        *(void**)ptr = alloc->free[header->cls];
+        alloc->free[header->cls] = header;
+    }
+}
+
+void* tic_script_alloc_realloc(tic_script_alloc* alloc, void* ptr, size_t size)
+{
+    if(!ptr)
+        return tic_script_alloc_malloc(alloc, size);
+
+    if(size == 0)
+    {
+        tic_script_alloc_free(alloc, ptr);
+        return NULL;
+    }
+
+    Header* header = getHeader(ptr);
+
+    if(header->cls == LARGE_CLASS)
+    {
+        if(size > ClassSizes[TIC_ALLOC_CLASSES - 1])
+        {
+            tic_alloc_large* block = getLarge(header);
+            size_t prevTotal = sizeof(tic_alloc_large) + header->size;
+            size_t total = sizeof(tic_alloc_large) + size;
+
+            if(total > prevTotal && !reserve(alloc, total - prevTotal))
+                return NULL;
+
+            tic_alloc_large* moved = realloc(block, total);
+
+            if(!moved)
+            {
+                if(total > prevTotal)
+                {
+                    alloc->used -= total - prevTotal;
+                    return NULL;
+                }
+
+                // shrinking never fails
+                return ptr;
+            }
+
+            if(total < prevTotal)
+                alloc->used -= prevTotal - total;
+
+            // the neighbours still point to the old address
+            if(moved->prev)
+                moved->prev->next = moved;
+            else
+                alloc->large = moved;
+
+            if(moved->next)
+                moved->next->prev = moved;
+
+            moved->header.size = size;
+            return moved + 1;
+        }
+    }
+    else if(header->cls < TIC_ALLOC_CLASSES && size <= ClassSizes[header->cls])
+    {
+        header->size = size;
+        return ptr;
+    }
+
+    void* data = tic_script_alloc_malloc(alloc, size);
+
+    if(data)
+    {
+        memcpy(data, ptr, MIN(size, header->size));
+        tic_script_alloc_free(alloc, ptr);
+    }
+    else if(size < header->size)
+        return ptr;
+
+    return data;
+}
+
+size_t tic_script_alloc_size(const void* ptr)
+{
+    return ptr ? getHeader(ptr)->size : 0;
+}
@@ -46,7 +46,7 @@ static_assert(sizeof(((tic_vram *)0)->vars) == 4, "tic_vram vars");
 static_assert(sizeof(tic_vram) == TIC_VRAM_SIZE,    "tic_vram");
 static_assert(sizeof(tic_ram) == TIC_RAM_SIZE,      "tic_ram");
 
-u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
+static inline u8 ramPeek(tic_mem* memory, s32 address, s32 bits)
 {
     if (address < 0)
         return 0;
@@ -65,7 +65,7 @@ u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
     return 0;
 }
 
-void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
+static inline void ramPoke(tic_mem* memory, s32 address, u8 value, s32 bits)
 {
     if (address < 0)
         return;
@@ -83,34 +83,60 @@ void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
     }
 }
 
+u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
+{
+    tic_core_stats_call(memory, tic_api_id_peek);
+    tic_core_draw_flush(memory);
+    return ramPeek(memory, address, bits);
+}
+
+void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
+{
+    tic_core_stats_call(memory, tic_api_id_poke);
+    tic_core_draw_flush(memory);
+    ramPoke(memory, address, value, bits);
+}
+
 u8 tic_api_peek4(tic_mem* memory, s32 address)
 {
-    return tic_api_peek(memory, address, 4);
+    tic_core_stats_call(memory, tic_api_id_peek4);
+    tic_core_draw_flush(memory);
+    return ramPeek(memory, address, 4);
 }
 
 u8 tic_api_peek1(tic_mem* memory, s32 address)
 {
-    return tic_api_peek(memory, address, 1);
+    tic_core_stats_call(memory, tic_api_id_peek1);
+    tic_core_draw_flush(memory);
+    return ramPeek(memory, address, 1);
 }
 
 void tic_api_poke1(tic_mem* memory, s32 address, u8 value)
 {
-    tic_api_poke(memory, address, value, 1);
+    tic_core_stats_call(memory, tic_api_id_poke1);
+    tic_core_draw_flush(memory);
+    ramPoke(memory, address, value, 1);
 }
 
 u8 tic_api_peek2(tic_mem* memory, s32 address)
 {
-    return tic_api_peek(memory, address, 2);
+    tic_core_stats_call(memory, tic_api_id_peek2);
+    tic_core_draw_flush(memory);
+    return ramPeek(memory, address, 2);
 }
 
 void tic_api_poke2(tic_mem* memory, s32 address, u8 value)
 {
-    tic_api_poke(memory, address, value, 2);
+    tic_core_stats_call(memory, tic_api_id_poke2);
+    tic_core_draw_flush(memory);
+    ramPoke(memory, address, value, 2);
 }
 
 void tic_api_poke4(tic_mem* memory, s32 address, u8 value)
 {
-    tic_api_poke(memory, address, value, 4);
+    tic_core_stats_call(memory, tic_api_id_poke4);
+    tic_core_draw_flush(memory);
+    ramPoke(memory, address, value, 4);
 }
 
 void tic_api_memcpy(tic_mem* memory, s32 dst, s32 src, s32 size)
@@ -118,6 +144,9 @@ void tic_api_memcpy(tic_mem* memory, s32 dst, s32 src, s32 size)
     tic_core* core = (tic_core*)memory;
     s32 bound = sizeof(tic_ram) - size;
 
+    tic_core_stats_call(memory, tic_api_id_memcpy);
+    tic_core_draw_flush(memory);
+
     if (size >= 0
         && size <= sizeof(tic_ram)
         && dst >= 0
@@ -135,6 +164,9 @@ void tic_api_memset(tic_mem* memory, s32 dst, u8 val, s32 size)
     tic_core* core = (tic_core*)memory;
     s32 bound = sizeof(tic_ram) - size;
 
+    tic_core_stats_call(memory, tic_api_id_memset);
+    tic_core_draw_flush(memory);
+
     if (size >= 0
         && size <= sizeof(tic_ram)
         && dst >= 0
@@ -148,6 +180,7 @@ void tic_api_memset(tic_mem* memory, s32 dst, u8 val, s32 size)
 void tic_api_trace(tic_mem* memory, const char* text, u8 color)
 {
     tic_core* core = (tic_core*)memory;
+    tic_core_stats_call(memory, tic_api_id_trace);
     core->data->trace(core->data->data, text ? text : "nil", color);
 }
 
@@ -155,6 +188,8 @@ u32 tic_api_pmem(tic_mem* tic, s32 index, u32 value, bool set)
 {
     u32 old = tic->ram->persistent.data[index];
 
+    tic_core_stats_call(tic, tic_api_id_pmem);
+
     if (set)
         tic->ram->persistent.data[index] = value;
 
@@ -164,6 +199,7 @@ u32 tic_api_pmem(tic_mem* tic, s32 index, u32 value, bool set)
 void tic_api_exit(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_exit);
     core->data->exit(core->data->data);
 }
 
@@ -185,9 +221,25 @@ static inline tic_vram* vbank1(tic_core* core)
     return core->state.vbank.id ? &core->memory.ram->vram : &core->state.vbank.mem;
 }
 
+// copies the borrowed bank on the first write, the rom stays read-only
+static tic_bank* ownBank(tic_core* core, s32 bank)
+{
+    tic_mem* tic = &core->memory;
+
+    if(core->rom.cart && !(core->rom.owned & (1 << bank)))
+    {
+        tic->cart.banks[bank] = core->rom.cart->banks[bank];
+        core->rom.owned |= 1 << bank;
+    }
+
+    return &tic->cart.banks[bank];
+}
+
 void tic_api_sync(tic_mem* tic, u32 mask, s32 bank, bool toCart)
 {
     tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_sync);
+    tic_core_draw_flush(tic);
 
     static const struct { s32 bank; s32 ram; s32 size; u8 mask; } Sections[] = 
     { 
@@ -209,7 +261,7 @@ void tic_api_sync(tic_mem* tic, u32 mask, s32 bank, bool toCart)
         u32 sectionMask = Sections[i].mask;
         if(mask & sectionMask)
         {
-            tic_bank* bankPtr = &tic->cart.banks[bank];
+            tic_bank* bankPtr = toCart ? ownBank(core, bank) : (tic_bank*)tic_core_bank(tic, bank);
             s32 size = Sections[i].size;
 
             if(sectionMask == tic_sync_palette)
@@ -233,12 +285,14 @@ void tic_api_sync(tic_mem* tic, u32 mask, s32 bank, bool toCart)
 double tic_api_time(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
+    tic_core_stats_call(memory, tic_api_id_time);
     return (double)(core->data->counter(core->data->data) - core->data->start) * 1000.0 / core->data->freq(core->data->data);
 }
 
 s32 tic_api_tstamp(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
+    tic_core_stats_call(memory, tic_api_id_tstamp);
     return (s32)time(NULL);
 }
 
@@ -257,11 +311,45 @@ static bool compareMetatag(const char* code, const char* tag, const char* value,
     return result;
 }
 
+void tic_core_load_rom(tic_mem* memory, const tic_cartridge* rom)
+{
+    tic_core* core = (tic_core*)memory;
+
+    core->rom.cart = rom;
+    core->rom.owned = 0;
+
+    if(rom)
+    {
+        // the banks are read from the rom until they are synced back,
+        // the unused code and binary of tic->cart are never touched
+        memory->cart.code.data[0] = '\0';
+        memory->cart.binary.size = 0;
+        memory->cart.lang = rom->lang;
+    }
+}
+
+const tic_cartridge* tic_core_rom(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    return core->rom.cart ? core->rom.cart : &memory->cart;
+}
+
+const tic_bank* tic_core_bank(tic_mem* memory, s32 bank)
+{
+    tic_core* core = (tic_core*)memory;
+
+    return core->rom.cart && !(core->rom.owned & (1 << bank))
+        ? &core->rom.cart->banks[bank]
+        : &memory->cart.banks[bank];
+}
+
 const tic_script_config* tic_core_script_config(tic_mem* memory)
 {
+    const tic_cartridge* rom = tic_core_rom(memory);
+
     FOR_EACH_LANG(it)
     {
-        if(it->id == memory->cart.lang || compareMetatag(memory->cart.code.data, "script", it->name, it->singleComment))
+        if(it->id == rom->lang || compareMetatag(rom->code.data, "script", it->name, it->singleComment))
             return it;
     }
     FOR_EACH_LANG_END
@@ -269,10 +357,184 @@ const tic_script_config* tic_core_script_config(tic_mem* memory)
     return Languages[0];
 }
 
+typedef struct
+{
+    u8 magic[4];
+    u8 lang;
+    u8 temp[3];
+    u32 hash;
+    u32 size;
+} BytecodeHeader;
+
+static const u8 BytecodeMagic[] = {'T', 'I', 'C', 'B'};
+
+static_assert(sizeof(BytecodeHeader) == 16, "tic_bytecode_header");
+
+static const BytecodeHeader* bytecodeHeader(const tic_binary* binary)
+{
+    const BytecodeHeader* header = (const BytecodeHeader*)binary->data;
+
+    return binary->size > sizeof(BytecodeHeader)
+        && memcmp(header->magic, BytecodeMagic, sizeof BytecodeMagic) == 0
+        && retro_le_to_cpu32(header->size) <= binary->size - sizeof(BytecodeHeader)
+        ? header : NULL;
+}
+
+static const void* cartBytecode(tic_mem* memory, u32 hash, s32* size)
+{
+    tic_core* core = (tic_core*)memory;
+    const BytecodeHeader* header = bytecodeHeader(&tic_core_rom(memory)->binary);
+
+    if(core->trustBytecode && header
+        && header->lang == core->currentScript->id
+        && retro_le_to_cpu32(header->hash) == hash)
+    {
+        *size = retro_le_to_cpu32(header->size);
+        return header + 1;
+    }
+
+    return NULL;
+}
+
+void tic_core_trust_bytecode(tic_mem* memory, bool trust)
+{
+    ((tic_core*)memory)->trustBytecode = trust;
+}
+
+tic_compile_result tic_core_compile(tic_mem* memory)
+{
+    const tic_script_config* config = tic_core_script_config(memory);
+    const char* code = memory->cart.code.data;
+    tic_binary* binary = &memory->cart.binary;
+
+    // only the previously embedded bytecode can be replaced
+    if(binary->size && !bytecodeHeader(binary))
+        return tic_compile_binary_used;
+
+    tic_compile_result result = tic_compile_error;
+
+    // the bytecode can't be embedded into the borrowed cart
+    if(config->compile && *code && !((tic_core*)memory)->rom.cart)
+    {
+        s32 size = 0;
+        void* data = config->compile(memory, code, &size);
+
+        if(data)
+        {
+            if(size <= sizeof binary->data - sizeof(BytecodeHeader))
+            {
+                BytecodeHeader header =
+                {
+                    .lang = config->id,
+                    .hash = retro_cpu_to_le32(tic_tool_crc32(code, (s32)strlen(code))),
+                    .size = retro_cpu_to_le32(size),
+                };
+
+                memcpy(header.magic, BytecodeMagic, sizeof BytecodeMagic);
+                memcpy(binary->data, &header, sizeof header);
+                memcpy(binary->data + sizeof header, data, size);
+                binary->size = sizeof header + size;
+
+                result = tic_compile_done;
+            }
+
+            free(data);
+        }
+    }
+
+    return result;
+}
+
+static tic_code_cache* addCacheEntry(tic_core* core, const char* name, const u8* hash)
+{
+    tic_code_cache* entry = &core->cache[core->cacheNext];
+    core->cacheNext = (core->cacheNext + 1) % TIC_CODE_CACHE_SIZE;
+
+    FREE(entry->data);
+    *entry = (tic_code_cache){.name = name};
+    memcpy(entry->hash, hash, TIC_MD5_SIZE);
+
+    return entry;
+}
+
+static const char* hash2str(const u8* hash)
+{
+    static char str[TIC_MD5_SIZE * 2 + 1];
+
+    for(s32 i = 0; i < TIC_MD5_SIZE; i++)
+        snprintf(str + i * 2, sizeof("ff"), "%02x", hash[i]);
+
+    return str;
+}
+
+const void* tic_core_cache_load(tic_mem* memory, const char* name, const char* code, s32* size)
+{
+    tic_core* core = (tic_core*)memory;
+    s32 length = (s32)strlen(code);
+
+    // bytecode shipped with the cart has priority
+    if(core->currentScript && strcmp(core->currentScript->name, name) == 0)
+    {
+        const void* bytecode = cartBytecode(memory, tic_tool_crc32(code, length), size);
+
+        if(bytecode)
+            return bytecode;
+    }
+
+    u8 hash[TIC_MD5_SIZE];
+    tic_tool_md5(code, length, hash);
+
+    for(s32 i = 0; i < TIC_CODE_CACHE_SIZE; i++)
+    {
+        const tic_code_cache* entry = &core->cache[i];
+
+        if(entry->data 
+            && memcmp(entry->hash, hash, TIC_MD5_SIZE) == 0
+            && strcmp(entry->name, name) == 0)
+        {
+            *size = entry->size;
+            return entry->data;
+        }
+    }
+
+    if(core->data && core->data->cacheLoad)
+    {
+        s32 loaded = 0;
+        void* data = core->data->cacheLoad(core->data->data, name, hash2str(hash), &loaded);
+
+        if(data)
+        {
+            tic_code_cache* entry = addCacheEntry(core, name, hash);
+            entry->data = data;
+            entry->size = *size = loaded;
+
+            return data;
+        }
+    }
+
+    return NULL;
+}
+
+void tic_core_cache_save(tic_mem* memory, const char* name, const char* code, const void* buffer, s32 size)
+{
+    tic_core* core = (tic_core*)memory;
+
+    u8 hash[TIC_MD5_SIZE];
+    tic_tool_md5(code, (s32)strlen(code), hash);
+
+    tic_code_cache* entry = addCacheEntry(core, name, hash);
+    entry->data = malloc(size);
+    entry->size = size;
+    memcpy(entry->data, buffer, size);
+
+    if(core->data && core->data->cacheSave)
+        core->data->cacheSave(core->data->data, name, hash2str(hash), buffer, size);
+}
+
 static void updateSaveid(tic_mem* memory)
 {
     memset(memory->saveid, 0, sizeof memory->saveid);
-    char* saveid = tic_tool_metatag(memory->cart.code.data, "saveid", tic_core_script_config(memory)->singleComment);
+    char* saveid = tic_tool_metatag(tic_core_rom(memory)->code.data, "saveid", tic_core_script_config(memory)->singleComment);
     if (saveid)
     {
         strncpy(memory->saveid, saveid, TIC_SAVEID_SIZE - 1);
@@ -316,7 +578,7 @@ static void resetVbank(tic_mem* memory)
 
     static const u8 DefaultMapping[] = { 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe };
     memcpy(memory->ram->vram.mapping, DefaultMapping, sizeof DefaultMapping);
-    memory->ram->vram.palette = memory->cart.bank0.palette.vbank0;
+    memory->ram->vram.palette = tic_core_bank(memory, 0)->palette.vbank0;
     memory->ram->vram.blit.segment = TIC_DEFAULT_BLIT_MODE;
 }
 
@@ -356,6 +618,8 @@ static void font2ram(tic_mem* memory)
 void tic_api_reset(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
+    tic_core_stats_call(memory, tic_api_id_reset);
+    tic_core_draw_flush(memory);
 
     // keyboard state is critical and must be preserved across API resets.
     // Often `tic_api_reset` is called to effect transitions between modes
@@ -400,7 +664,7 @@ static void cart2ram(tic_mem* memory)
     };
 
     // don't sync empty screen
-    tic_api_sync(memory, EMPTY(memory->cart.bank0.screen.data) ? noscreen : all, 0, false);
+    tic_api_sync(memory, EMPTY(tic_core_bank(memory, 0)->screen.data) ? noscreen : all, 0, false);
 }
 
 static void tic_close_current_vm(tic_core* core)
@@ -412,14 +676,68 @@ static void tic_close_current_vm(tic_core* core)
         core->currentScript->close( (tic_mem*)core );
         core->currentVM = NULL;
     }
+
+    // drops whatever the VM left behind
+    tic_script_alloc_rewind(&core->alloc);
     if (core->memory.ram == NULL) {
         core->memory.ram = core->memory.base_ram;
     }
 }
 
+static size_t getMemoryLimit(tic_core* core, const tic_script_config* config)
+{
+    s32 limit = TIC_SCRIPT_MEMORY_LIMIT;
+    char* tag = tic_tool_metatag(tic_core_rom(&core->memory)->code.data, "memlimit", config->singleComment);
+
+    if(tag)
+    {
+        s32 value = atoi(tag);
+
+        if(value > 0)
+            limit = CLAMP(value, TIC_SCRIPT_MEMORY_MIN, TIC_SCRIPT_MEMORY_MAX);
+
+        free(tag);
+    }
+
+    return (size_t)limit * 1024;
+}
+
+static void dropWarmVM(tic_core* core)
+{
+    tic_script_alloc_release(&core->alloc);
+    core->warm.script = NULL;
+    core->warm.vm = NULL;
+}
+
+static void prepareVM(tic_core* core, const tic_script_config* config)
+{
+    core->alloc.limit = getMemoryLimit(core, config);
+
+    if(core->warm.script != config)
+    {
+        dropWarmVM(core);
+
+        if(config->create)
+        {
+            void* vm = config->create((tic_mem*)core);
+
+            if(vm && tic_script_alloc_snapshot(&core->alloc))
+            {
+                core->warm.script = config;
+                core->warm.vm = vm;
+            }
+            else dropWarmVM(core);
+        }
+    }
+
+    // the heap is already rewound to the snapshot by the previous close
+    core->currentVM = core->warm.vm;
+}
+
 static bool tic_init_vm(tic_core* core, const char* code, const tic_script_config* config)
 {
     tic_close_current_vm(core);
+    prepareVM(core, config);
     // set current script config and init
     core->currentScript = config;
     bool done = config->init( (tic_mem*) core , code);
@@ -427,6 +745,7 @@ static bool tic_init_vm(tic_core* core, const char* code, const tic_script_confi
     {
         // if it couldn't init, make sure the VM is not left dirty by the implementation
         core->currentVM = NULL;
+        tic_script_alloc_rewind(&core->alloc);
     }
     else
     {
@@ -435,9 +754,257 @@ static bool tic_init_vm(tic_core* core, const char* code, const tic_script_confi
     return done;
 }
 
+static void initGC(tic_core* core, const tic_script_config* config)
+{
+    const char* code = tic_core_rom(&core->memory)->code.data;
+
+    char* mode = tic_tool_metatag(code, "gc", config->singleComment);
+    if(mode)
+    {
+        static const char* const Modes[] = 
+        {
+            [tic_gc_auto] = "auto",
+            [tic_gc_incremental] = "incremental",
+            [tic_gc_generational] = "generational",
+            [tic_gc_manual] = "manual",
+        };
+
+        for(s32 i = 0; i < COUNT_OF(Modes); i++)
+            if(strcmp(mode, Modes[i]) == 0)
+                core->state.gc.mode = i;
+
+        free(mode);
+    }
+
+    char* step = tic_tool_metatag(code, "gcstep", config->singleComment);
+    if(step)
+    {
+        core->state.gc.step = MAX(atoi(step), 0);
+        free(step);
+    }
+    else if(core->state.gc.mode == tic_gc_manual)
+        core->state.gc.step = TIC_GC_DEFAULT_STEP;
+
+    if(core->state.gc.mode != tic_gc_auto && config->gc.mode)
+        config->gc.mode(&core->memory, core->state.gc.mode);
+}
+
+static inline u64 statsEnter(tic_core* core)
+{
+    u64 start = tic_core_stats_counter(core);
+    core->stats.active = start != 0;
+    return start;
+}
+
+static inline void statsLeave(tic_core* core, u64 start, u64* time)
+{
+    if(start)
+    {
+        *time += tic_core_stats_counter(core) - start;
+        core->stats.active = false;
+    }
+}
+
+static void publishStats(tic_core* core)
+{
+    static const char* const ApiNames[] = 
+    {
+#define API_NAME_DEF(name, ...) #name,
+        TIC_API_LIST(API_NAME_DEF)
+#undef API_NAME_DEF
+    };
+
+    tic_core_stats_data* stats = &core->stats;
+    tic80_stats* frame = &stats->frame;
+    u64 freq = stats->freq ? stats->freq(stats->data) : 0;
+
+    if(freq)
+    {
+#define STATS_TIME(NAME) frame->time.NAME = (u32)(stats->time.NAME * 1000000 / freq)
+        STATS_TIME(tick);
+        STATS_TIME(scanline);
+        STATS_TIME(border);
+        STATS_TIME(draw);
+        STATS_TIME(blit);
+        STATS_TIME(sound);
+#undef  STATS_TIME
+    }
+
+    frame->hasHeap = core->currentVM && core->currentScript->gc.heap;
+    frame->heap = frame->hasHeap ? core->currentScript->gc.heap(&core->memory) : 0;
+
+    memcpy(stats->frameCalls, stats->calls, sizeof stats->calls);
+    frame->calls.count = tic_api_id_count;
+    frame->calls.names = ApiNames;
+    frame->calls.values = stats->frameCalls;
+
+    ZEROMEM(stats->time);
+    ZEROMEM(stats->calls);
+}
+
+void tic_core_stats_enable(tic_mem* memory, bool enable)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(core->stats.enabled != enable)
+    {
+        ZEROMEM(core->stats.time);
+        ZEROMEM(core->stats.calls);
+        ZEROMEM(core->stats.frame.time);
+        ZEROMEM(core->stats.frameCalls);
+        core->stats.enabled = enable;
+        core->stats.active = false;
+    }
+}
+
+const tic80_stats* tic_core_stats(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    return core->stats.enabled ? &core->stats.frame : NULL;
+}
+
+static void clearProfile(tic_core* core)
+{
+    tic_profile_data* profile = &core->profile;
+
+    for(s32 i = 0; i < profile->capacity; i++)
+        free(profile->samples[i].stack);
+
+    FREE(profile->samples);
+    profile->count = profile->capacity = 0;
+}
+
+static tic_profile_sample* findSample(tic_profile_sample* samples, s32 capacity, const char* stack, u32 hash)
+{
+    for(s32 i = hash & (capacity - 1);; i = (i + 1) & (capacity - 1))
+    {
+        tic_profile_sample* it = samples + i;
+
+        if(!it->stack || (it->hash == hash && strcmp(it->stack, stack) == 0))
+            return it;
+    }
+}
+
+bool tic_core_profile_due(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    tic_profile_data* profile = &core->profile;
+
+    if(!profile->enabled || !core->data)
+        return false;
+
+    u64 now = core->data->counter(core->data->data);
+
+    if(now < profile->next)
+        return false;
+
+    profile->next = now + core->data->freq(core->data->data) * TIC_PROFILE_INTERVAL / 1000;
+    return true;
+}
+
+void tic_core_profile_sample(tic_mem* memory, const char* stack)
+{
+    tic_core* core = (tic_core*)memory;
+    tic_profile_data* profile = &core->profile;
+
+    // keep the table at most half full
+    if((profile->count + 1) * 2 > profile->capacity)
+    {
+        s32 capacity = profile->capacity ? profile->capacity * 2 : 256;
+        tic_profile_sample* samples = calloc(capacity, sizeof *samples);
+
+        for(s32 i = 0; i < profile->capacity; i++)
+        {
+            const tic_profile_sample* it = profile->samples + i;
+
+            if(it->stack)
+                *findSample(samples, capacity, it->stack, it->hash) = *it;
+        }
+
+        free(profile->samples);
+        profile->samples = samples;
+        profile->capacity = capacity;
+    }
+
+    u32 hash = tic_tool_crc32(stack, (s32)strlen(stack));
+    tic_profile_sample* sample = findSample(profile->samples, profile->capacity, stack, hash);
+
+    if(!sample->stack)
+    {
+        sample->stack = strdup(stack);
+        sample->hash = hash;
+        profile->count++;
+    }
+
+    sample->count++;
+}
+
+bool tic_core_profile_start(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    const tic_script_config* config = tic_core_script_config(memory);
+
+    if(!config->profile)
+        return false;
+
+    clearProfile(core);
+    core->profile.enabled = true;
+    core->profile.next = 0;
+
+    // otherwise the hooks are set when the VM is started
+    if(core->currentVM && core->currentScript == config)
+        config->profile(memory, true);
+
+    return true;
+}
+
+void tic_core_profile_stop(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(core->profile.enabled && core->currentVM && core->currentScript->profile)
+        core->currentScript->profile(memory, false);
+
+    core->profile.enabled = false;
+}
+
+void* tic_core_profile_export(tic_mem* memory, s32* size)
+{
+    tic_core* core = (tic_core*)memory;
+    const tic_profile_data* profile = &core->profile;
+
+    *size = 0;
+
+    if(!profile->count)
+        return NULL;
+
+    // collapsed stacks format, one 'outer;inner count' line per stack,
+    // supported by flamegraph.pl and speedscope
+    s32 total = 0;
+    for(s32 i = 0; i < profile->capacity; i++)
+        if(profile->samples[i].stack)
+            total += (s32)strlen(profile->samples[i].stack) + sizeof " 4294967295\n";
+
+    char* buffer = malloc(total);
+    char* ptr = buffer;
+
+    for(s32 i = 0; i < profile->capacity; i++)
+    {
+        const tic_profile_sample* it = profile->samples + i;
+
+        if(it->stack)
+            ptr += sprintf(ptr, "%s %i\n", it->stack, it->count);
+    }
+
+    *size = (s32)(ptr - buffer);
+    return buffer;
+}
+
 s32 tic_api_vbank(tic_mem* tic, s32 bank)
 {
     tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_vbank);
+    tic_core_draw_flush(tic);
 
     s32 prev = core->state.vbank.id;
 
@@ -455,15 +1022,55 @@ s32 tic_api_vbank(tic_mem* tic, s32 bank)
     return prev;
 }
 
+// the layout of vars.offset
+typedef struct
+{
+    s8 x, y;
+} BlitOffset;
+
+static inline s32 rowfxSize(u8 mask)
+{
+    return (mask & TIC_ROWFX_PALETTE ? sizeof(tic_palette) : 0)
+        + (mask & TIC_ROWFX_OFFSET ? sizeof(BlitOffset) : 0)
+        + (mask & TIC_ROWFX_BORDER ? 1 : 0);
+}
+
+void tic_api_rowfx(tic_mem* tic, s32 address, u8 mask, s32 bank)
+{
+    tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_rowfx);
+
+    if(bank < 0 || bank >= TIC_ROWFX_BANKS)
+        return;
+
+    mask &= TIC_ROWFX_PALETTE | TIC_ROWFX_OFFSET | TIC_ROWFX_BORDER;
+
+    // the table must fit in RAM, otherwise it's turned off
+    if(address < 0 || !mask || address > TIC_RAM_SIZE - rowfxSize(mask) * TIC80_FULLHEIGHT)
+        address = -1, mask = 0;
+
+    core->state.rowfx[bank].address = address;
+    core->state.rowfx[bank].mask = mask;
+}
+
 void tic_core_tick(tic_mem* tic, tic_tick_data* data)
 {
     tic_core* core = (tic_core*)tic;
 
     core->data = data;
 
+    core->watchdog.budget = data->budget;
+    core->watchdog.left = core->state.initialized 
+        ? core->watchdog.budget 
+        : core->watchdog.budget * TIC_WATCHDOG_BOOT_SCALE;
+
+    core->stats.counter = data->counter;
+    core->stats.freq = data->freq;
+    core->stats.data = data->data;
+
     if (!core->state.initialized)
     {
-        const char* code = tic->cart.code.data;
+        const char* code = tic_core_rom(tic)->code.data;
 
         bool done = false;
         const tic_script_config* config = tic_core_script_config(tic);
@@ -483,13 +1090,15 @@ void tic_core_tick(tic_mem* tic, tic_tick_data* data)
                 tic->input.keyboard = 1;
             else tic->input.data = -1;  // default is all enabled
 
+            core->deferred.enabled = compareMetatag(code, "render", "deferred", config->singleComment);
+
             data->start = data->counter(core->data->data);
 
             // TODO: does where to fetch code from need to be a config option so this isn't hard
             // coded for just a single language? perhaps change it later when we have a second script
             // engine that uses BINARY?
             if (strcmp(config->name,"wasm")==0) {
-                code = tic->cart.binary.data;
+                code = tic_core_rom(tic)->binary.data;
             }
 
             done = tic_init_vm(core, code, config);
@@ -501,15 +1110,37 @@ void tic_core_tick(tic_mem* tic, tic_tick_data* data)
 
         if (done)
         {
+            initGC(core, config);
+
+            if(core->profile.enabled && config->profile)
+                config->profile(tic, true);
+
             config->boot(tic);
             core->state.tick = config->tick;
-            core->state.callback = config->callback;
             core->state.initialized = true;
         }
         else return;
     }
 
+    // the calls can't be recorded when the script writes the memory directly
+    core->deferred.recording = core->deferred.enabled && core->jobs && tic->ram == tic->base_ram;
+
+    u64 start = statsEnter(core);
     core->state.tick(tic);
+    core->deferred.recording = false;
+    tic_core_draw_flush(tic);
+    statsLeave(core, start, &core->stats.time.tick);
+
+    // collect garbage after the tick to avoid stalls inside TIC()
+    if(core->state.gc.step && core->currentScript->gc.step)
+        core->currentScript->gc.step(tic, core->state.gc.step);
+
+    // the callbacks can be (re)defined in TIC(), resolve them
+    // after every tick instead of looking them up on every row
+    core->state.callback = core->currentScript->callback;
+
+    if(core->currentScript->resolve)
+        core->currentScript->resolve(tic, &core->state.callback);
 }
 
 void tic_core_pause(tic_mem* memory)
@@ -551,6 +1182,14 @@ void tic_core_close(tic_mem* memory)
     core->state.initialized = false;
 
     tic_close_current_vm(core);
+    dropWarmVM(core);
+    tic_jobs_delete(core->jobs);
+    FREE(core->deferred.data);
+
+    for(s32 i = 0; i < TIC_CODE_CACHE_SIZE; i++)
+        FREE(core->cache[i].data);
+
+    clearProfile(core);
 
     blip_delete(core->blip.left);
     blip_delete(core->blip.right);
@@ -580,6 +1219,9 @@ void tic_core_tick_start(tic_mem* memory)
     core->state.gamepads.now.data = core->memory.ram->input.gamepads.data;
 
     core->state.synced = 0;
+
+    if(core->stats.enabled)
+        publishStats(core);
 }
 
 void tic_core_tick_end(tic_mem* memory)
@@ -627,14 +1269,53 @@ static inline void memset4(void* dst, u32 val, u32 dwords)
 #endif
 }
 
-static inline void updpal(tic_mem* tic, tic_blitpal* pal0, tic_blitpal* pal1)
+// converts the palette only when the colors or the screen format change
+static inline const tic_blitpal* cachedpal(tic_core* core, tic_blitpal_cache* cache, const tic_palette* palette)
+{
+    if(!cache->valid || cache->format != core->screen_format
+        || memcmp(cache->palette.data, palette->data, sizeof(tic_palette)))
+    {
+        cache->data = tic_tool_palette_blit(palette, core->screen_format);
+        cache->palette = *palette;
+        cache->format = core->screen_format;
+        cache->valid = true;
+    }
+
+    return &cache->data;
+}
+
+static inline void updpal(tic_mem* tic, const tic_blitpal** pal0, const tic_blitpal** pal1)
+{
+    tic_core* core = (tic_core*)tic;
+    *pal0 = cachedpal(core, &core->blitpal.vram[0], &vbank0(core)->palette);
+    *pal1 = cachedpal(core, &core->blitpal.vram[1], &vbank1(core)->palette);
+}
+
+// applies the table entry of the row over the palette and the offset from VRAM,
+// returns the border color of the entry if there is one
+static inline const u8* rowfxApply(tic_mem* tic, s32 bank, s32 row, const tic_blitpal** pal, BlitOffset* offset)
 {
     tic_core* core = (tic_core*)tic;
-    *pal0 = tic_tool_palette_blit(&vbank0(core)->palette, core->screen_format);
-    *pal1 = tic_tool_palette_blit(&vbank1(core)->palette, core->screen_format);
+    u8 mask = core->state.rowfx[bank].mask;
+    const u8* entry = (const u8*)tic->ram + core->state.rowfx[bank].address + rowfxSize(mask) * row;
+
+    if(mask & TIC_ROWFX_PALETTE)
+    {
+        *pal = cachedpal(core, &core->blitpal.rowfx[bank], (const tic_palette*)entry);
+        entry += sizeof(tic_palette);
+    }
+
+    if(mask & TIC_ROWFX_OFFSET)
+    {
+        memcpy(offset, entry, sizeof(BlitOffset));
+        entry += sizeof(BlitOffset);
+    }
+
+    return mask & TIC_ROWFX_BORDER ? entry : NULL;
 }
 
-static inline void updbdr(tic_mem* tic, s32 row, u32* ptr, tic_blit_callback clb, tic_blitpal* pal0, tic_blitpal* pal1)
+static inline void updbdr(tic_mem* tic, s32 row, u32* ptr, tic_blit_callback clb,
+    const tic_blitpal** pal0, const tic_blitpal** pal1, BlitOffset* offset0, BlitOffset* offset1)
 {
     tic_core* core = (tic_core*)tic;
 
@@ -650,7 +1331,21 @@ static inline void updbdr(tic_mem* tic, s32 row, u32* ptr, tic_blit_callback clb
     if(clb.border || clb.scanline)
         updpal(tic, pal0, pal1);
 
-    memset4(ptr, pal0->data[vbank0(core)->vars.border], TIC80_FULLWIDTH);
+    memcpy(offset0, &vbank0(core)->vars.offset, sizeof(BlitOffset));
+    memcpy(offset1, &vbank1(core)->vars.offset, sizeof(BlitOffset));
+
+    u8 border = vbank0(core)->vars.border;
+
+    if(core->state.rowfx[0].mask)
+    {
+        const u8* entry = rowfxApply(tic, 0, row, pal0, offset0);
+        if(entry) border = *entry & (TIC_PALETTE_SIZE - 1);
+    }
+
+    if(core->state.rowfx[1].mask)
+        rowfxApply(tic, 1, row, pal1, offset1);
+
+    memset4(ptr, (*pal0)->data[border], TIC80_FULLWIDTH);
 }
 
 static inline u32 blitpix(tic_mem* tic, s32 offset0, s32 offset1, const tic_blitpal* pal0, const tic_blitpal* pal1)
@@ -667,13 +1362,22 @@ void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb)
 {
     tic_core* core = (tic_core*)tic;
 
-    tic_blitpal pal0, pal1;
+    // SCN() and BDR() get their own budget
+    core->watchdog.left = core->watchdog.budget;
+
+    // the callbacks time is excluded from the blit
+    u64 start = tic_core_stats_counter(core);
+    u64 callbacks = core->stats.time.scanline + core->stats.time.border;
+
+    const tic_blitpal *pal0, *pal1;
     updpal(tic, &pal0, &pal1);
 
+    BlitOffset offset0, offset1;
+
     s32 row = 0;
     u32* rowPtr = tic->product.screen;
 
-#define UPDBDR() updbdr(tic, row, rowPtr, clb, &pal0, &pal1)
+#define UPDBDR() updbdr(tic, row, rowPtr, clb, &pal0, &pal1, &offset0, &offset1)
 
     for(; row != TIC80_MARGIN_TOP; ++row, rowPtr += TIC80_FULLWIDTH)
         UPDBDR();
@@ -683,24 +1387,24 @@ void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb)
         UPDBDR();
         rowPtr += TIC80_MARGIN_LEFT;
 
-        if(*(u16*)&vbank0(core)->vars.offset == 0 && *(u16*)&vbank1(core)->vars.offset == 0)
+        if((offset0.x | offset0.y | offset1.x | offset1.y) == 0)
         {
             // render line without XY offsets
             for(s32 x = (row - TIC80_MARGIN_TOP) * TIC80_WIDTH, end = x + TIC80_WIDTH; x != end; ++x)
-                *rowPtr++ = blitpix(tic, x, x, &pal0, &pal1);
+                *rowPtr++ = blitpix(tic, x, x, pal0, pal1);
         }
         else
         {
             // render line with XY offsets
             enum{OffsetY = TIC80_HEIGHT - TIC80_MARGIN_TOP};
-            s32 start0 = (row + vbank0(core)->vars.offset.y + OffsetY) % TIC80_HEIGHT * TIC80_WIDTH;
-            s32 start1 = (row + vbank1(core)->vars.offset.y + OffsetY) % TIC80_HEIGHT * TIC80_WIDTH;
-            s32 offsetX0 = vbank0(core)->vars.offset.x;
-            s32 offsetX1 = vbank1(core)->vars.offset.x;
+            s32 start0 = (row + offset0.y + OffsetY) % TIC80_HEIGHT * TIC80_WIDTH;
+            s32 start1 = (row + offset1.y + OffsetY) % TIC80_HEIGHT * TIC80_WIDTH;
+            s32 offsetX0 = offset0.x;
+            s32 offsetX1 = offset1.x;
 
             for(s32 x = TIC80_WIDTH; x != 2 * TIC80_WIDTH; ++x)
                 *rowPtr++ = blitpix(tic, (x + offsetX0) % TIC80_WIDTH + start0, 
-                    (x + offsetX1) % TIC80_WIDTH + start1, &pal0, &pal1);
+                    (x + offsetX1) % TIC80_WIDTH + start1, pal0, pal1);
         }
 
         rowPtr += TIC80_MARGIN_RIGHT;
@@ -710,6 +1414,10 @@ void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb)
         UPDBDR();
 
 #undef  UPDBDR
+
+    if(start)
+        core->stats.time.blit += tic_core_stats_counter(core) - start 
+            - (core->stats.time.scanline + core->stats.time.border - callbacks);
 }
 
 static inline void scanline(tic_mem* memory, s32 row, void* data)
@@ -717,7 +1425,11 @@ static inline void scanline(tic_mem* memory, s32 row, void* data)
     tic_core* core = (tic_core*)memory;
 
     if (core->state.initialized)
+    {
+        u64 start = statsEnter(core);
         core->state.callback.scanline(memory, row, data);
+        statsLeave(core, start, &core->stats.time.scanline);
+    }
 }
 
 static inline void border(tic_mem* memory, s32 row, void* data)
@@ -725,18 +1437,34 @@ static inline void border(tic_mem* memory, s32 row, void* data)
     tic_core* core = (tic_core*)memory;
 
     if (core->state.initialized)
+    {
+        u64 start = statsEnter(core);
         core->state.callback.border(memory, row, data);
+        statsLeave(core, start, &core->stats.time.border);
+    }
 }
 
 void tic_core_blit(tic_mem* tic)
 {
-    tic_core_blit_ex(tic, (tic_blit_callback){scanline, border, NULL});
+    tic_core* core = (tic_core*)tic;
+
+    tic_core_blit_ex(tic, (tic_blit_callback)
+    {
+        core->state.callback.scanline ? scanline : NULL, 
+        core->state.callback.border ? border : NULL, 
+        NULL
+    });
 }
 
 tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
 {
-    tic_core* core = (tic_core*)malloc(sizeof(tic_core));
-    memset(core, 0, sizeof(tic_core));
+    return tic_core_create_ex(samplerate, format, 0);
+}
+
+tic_mem* tic_core_create_ex(s32 samplerate, tic80_pixel_color_format format, s32 threads)
+{
+    // calloc leaves the pages of the unused cart banks uncommitted
+    tic_core* core = (tic_core*)calloc(1, sizeof(tic_core));
 
     tic80* product = &core->memory.product;
 
@@ -763,6 +1491,8 @@ tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
     blip_set_rates(core->blip.left, CLOCKRATE, samplerate);
     blip_set_rates(core->blip.right, CLOCKRATE, samplerate);
 
+    core->jobs = tic_jobs_create(threads);
+
     tic_api_reset(&core->memory);
 
     return &core->memory;
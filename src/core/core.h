@@ -29,6 +29,24 @@
 #define CLOCKRATE (255<<13)
 #define TIC_DEFAULT_COLOR 15
 #define TIC_SOUND_RINGBUF_LEN 12 // in worst case, this induces ~ 12 tick delay i.e. 200 ms
+#define TIC_CODE_CACHE_SIZE 4
+#define TIC_GC_DEFAULT_STEP 64 // KB per tick in the manual GC mode
+#define TIC_PROFILE_INTERVAL 1 // ms between the profiler samples
+#define TIC_JOBS_MIN_AREA (64 * 64) // pixels, smaller draw calls don't pay off waking the threads
+#define TIC_DEFERRED_BUFFER_SIZE (64 * 1024)
+#define TIC_DEFERRED_BUFFER_MAX (4 * 1024 * 1024) // the longer lists are rasterized by parts
+#define TIC_DEFERRED_BANDS 2 // per thread, evens out the bands with more to draw
+#define TIC_ROWFX_BANKS 2 // one table per vbank
+#define TIC_ROWFX_PALETTE 1
+#define TIC_ROWFX_OFFSET 2
+#define TIC_ROWFX_BORDER 4
+#define TIC_WATCHDOG_BOOT_SCALE 4 // the code, BOOT() and the first TIC() can precompute more
+#define TIC_WATCHDOG_ERROR "the script ran over the instruction budget of the watchdog, an endless loop or too much work for a tick"
+#define TIC_ALLOC_CLASSES 16
+#define TIC_ALLOC_CHUNK_SIZE (64 * 1024)
+#define TIC_SCRIPT_MEMORY_LIMIT (64 * 1024) // KB, can be changed with the memlimit metatag
+#define TIC_SCRIPT_MEMORY_MIN 1024 // KB, enough to boot any of the VMs
+#define TIC_SCRIPT_MEMORY_MAX (1024 * 1024) // KB
 
 typedef struct
 {
@@ -147,6 +165,12 @@ typedef struct
 
     tic_tick tick;
     tic_blit_callback callback;
+
+    struct
+    {
+        tic_gc_mode mode;
+        s32 step;
+    } gc;
     
     u32 synced;
 
@@ -161,9 +185,108 @@ typedef struct
         s32 l, t, r, b;
     } clip;
 
+    // the per-row effects tables in RAM set by rowfx()
+    struct
+    {
+        s32 address;
+        u8 mask;
+    } rowfx[TIC_ROWFX_BANKS];
+
     bool initialized;
 } tic_core_state_data;
 
+typedef struct
+{
+    const char* name;
+    u8 hash[TIC_MD5_SIZE];
+    s32 size;
+    void* data;
+} tic_code_cache;
+
+typedef struct
+{
+    char* stack;
+    u32 hash;
+    s32 count;
+} tic_profile_sample;
+
+typedef struct
+{
+    bool enabled;
+    u64 next;
+
+    // open addressing hash table of the collapsed stacks
+    tic_profile_sample* samples;
+    s32 count;
+    s32 capacity;
+} tic_profile_data;
+
+typedef struct tic_jobs tic_jobs;
+
+// runs the band of the job, the bands are split between the threads
+typedef void(*tic_job_func)(void* data, s32 band, s32 count);
+
+typedef struct tic_alloc_chunk tic_alloc_chunk;
+typedef struct tic_alloc_large tic_alloc_large;
+typedef struct tic_alloc_snapshot tic_alloc_snapshot;
+
+// the script VM heap, small blocks are pooled by the size classes,
+// everything is released at once when the VM is closed
+typedef struct
+{
+    size_t limit; // in bytes, 0 is unlimited
+    size_t used;
+    bool exhausted;
+
+    void* free[TIC_ALLOC_CLASSES];
+
+    tic_alloc_chunk* chunks;
+    u8* cursor;
+    u8* end;
+
+    tic_alloc_large* large;
+    tic_alloc_snapshot* snapshot;
+} tic_script_alloc;
+
+typedef struct
+{
+    bool enabled;
+
+    // set while the script code is running outside of the draw calls,
+    // only these API calls are counted
+    bool active;
+
+    CounterCallback counter;
+    FreqCallback freq;
+    void* data;
+
+    // accumulated during the current frame, in counter ticks
+    struct
+    {
+        u64 tick;
+        u64 scanline;
+        u64 border;
+        u64 draw;
+        u64 blit;
+        u64 sound;
+    } time;
+
+    u32 calls[tic_api_id_count];
+
+    // the last complete frame
+    tic80_stats frame;
+    u32 frameCalls[tic_api_id_count];
+} tic_core_stats_data;
+
+// the palette converted to the screen format, kept while the colors don't change
+typedef struct
+{
+    tic_palette palette;
+    tic80_pixel_color_format format;
+    tic_blitpal data;
+    bool valid;
+} tic_blitpal_cache;
+
 typedef struct
 {
     tic_mem memory; // it should be first
@@ -182,6 +305,64 @@ typedef struct
     tic_tick_data* data;
     tic_core_state_data state;
 
+    // compiled code of the recently started carts
+    tic_code_cache cache[TIC_CODE_CACHE_SIZE];
+
+    s32 cacheNext;
+
+    // the bytecode embedded in the cart isn't verified by the engines,
+    // it's executed only when the host trusts the carts it runs
+    bool trustBytecode;
+
+    tic_core_stats_data stats;
+    tic_profile_data profile;
+    tic_script_alloc alloc;
+
+    // the blit palettes of each vbank from VRAM and from the rowfx() table
+    struct
+    {
+        tic_blitpal_cache vram[TIC_ROWFX_BANKS];
+        tic_blitpal_cache rowfx[TIC_ROWFX_BANKS];
+    } blitpal;
+
+    // optional worker threads for the heavy draw calls
+    tic_jobs* jobs;
+
+    // the cart borrowed by tic80_load_ex, its code and binary are used in place,
+    // a bank is copied to tic->cart only when sync() first writes to it
+    struct
+    {
+        const tic_cartridge* cart;
+        u8 owned;
+    } rom;
+
+    // the draw calls of TIC() are recorded when the cart asks for the deferred
+    // rendering and rasterized in bands before the memory is accessed
+    struct
+    {
+        bool enabled;
+        bool recording;
+        struct ClipRect clip; // at the first recorded call
+        u8* data;
+        u32 size;
+        u32 capacity;
+    } deferred;
+
+    // instructions left for the current tick or blit
+    struct
+    {
+        u64 budget;
+        s64 left;
+    } watchdog;
+
+    // the VM with the API registered, the script heap is
+    // rewound to it instead of creating a new one on restart
+    struct
+    {
+        const tic_script_config* script;
+        void* vm;
+    } warm;
+
     struct
     {
         tic_core_state_data state;   
@@ -201,6 +382,83 @@ void tic_core_tick_io(tic_mem* memory);
 void tic_core_sound_tick_start(tic_mem* memory);
 void tic_core_sound_tick_end(tic_mem* memory);
 
+const void* tic_core_cache_load(tic_mem* memory, const char* name, const char* code, s32* size);
+void tic_core_cache_save(tic_mem* memory, const char* name, const char* code, const void* buffer, s32 size);
+
+// called by the script engine hooks, the stack is a list of
+// frames separated by ';' starting from the outermost one
+bool tic_core_profile_due(tic_mem* memory);
+void tic_core_profile_sample(tic_mem* memory, const char* stack);
+
+void tic_script_alloc_release(tic_script_alloc* alloc);
+
+// rasterizes the recorded draw calls, does nothing in the immediate mode
+void tic_core_draw_flush(tic_mem* memory);
+
+// NULL when the core is built without TIC_BUILD_WITH_JOBS,
+// the jobs are run on the calling thread then
+tic_jobs* tic_jobs_create(s32 threads);
+void tic_jobs_delete(tic_jobs* jobs);
+s32 tic_jobs_threads(const tic_jobs* jobs);
+void tic_jobs_run(tic_jobs* jobs, tic_job_func func, void* data, s32 count);
+
+// saves the heap contents, rewind restores them in place and
+// drops everything allocated after, release drops the snapshot
+bool tic_script_alloc_snapshot(tic_script_alloc* alloc);
+void tic_script_alloc_rewind(tic_script_alloc* alloc);
+void* tic_script_alloc_malloc(tic_script_alloc* alloc, size_t size);
+void* tic_script_alloc_realloc(tic_script_alloc* alloc, void* ptr, size_t size);
+void tic_script_alloc_free(tic_script_alloc* alloc, void* ptr);
+size_t tic_script_alloc_size(const void* ptr);
+
+// called by the script engine interrupt hooks with the number of instructions
+// since the previous call, the script should be stopped when it returns true
+static inline bool tic_core_watchdog(tic_mem* memory, s32 instructions)
+{
+    tic_core* core = (tic_core*)memory;
+    return core->watchdog.budget && (core->watchdog.left -= instructions) < 0;
+}
+
+static inline u64 tic_core_stats_counter(tic_core* core)
+{
+    return core->stats.enabled && core->stats.counter 
+        ? core->stats.counter(core->stats.data) 
+        : 0;
+}
+
+static inline void tic_core_stats_call(tic_mem* memory, tic_api_id id)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(core->stats.active)
+        core->stats.calls[id]++;
+}
+
+// draw calls are timed, the nested API calls are not counted
+static inline u64 tic_core_stats_draw(tic_mem* memory, tic_api_id id)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(!core->stats.active) 
+        return 0;
+
+    core->stats.calls[id]++;
+    core->stats.active = false;
+
+    return core->stats.counter(core->stats.data);
+}
+
+static inline void tic_core_stats_draw_end(tic_mem* memory, u64 start)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(start)
+    {
+        core->stats.time.draw += core->stats.counter(core->stats.data) - start;
+        core->stats.active = true;
+    }
+}
+
 #if defined(BUILD_DEPRECATED)
 // mouse cursor is the same in both modes
 // for backward compatibility
@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+
 #include "api.h"
 #include "core.h"
 #include "tilesheet.h"
@@ -31,7 +32,88 @@
 
 #define TRANSPARENT_COLOR 255
 
-typedef void(*PixelFunc)(tic_mem* memory, s32 x, s32 y, u8 color);
+typedef void(*PixelFunc)(void* data, s32 x, s32 y, u8 color);
+
+typedef enum
+{
+    DrawClip,
+    DrawCls,
+    DrawPix,
+    DrawRect,
+    DrawRectb,
+    DrawLine,
+    DrawTri,
+    DrawTrib,
+    DrawTtri,
+    DrawElli,
+    DrawEllib,
+    DrawSpr,
+    DrawMap,
+    DrawText,
+} DrawType;
+
+// the recorded draw call, followed by its arguments
+typedef struct
+{
+    u8 type;
+    u8 color;
+    u32 size; // with the arguments, keeps the next call aligned
+} DrawCmd;
+
+typedef struct
+{
+    s32 x, y;
+} PixArgs;
+
+typedef struct
+{
+    s32 x, y, width, height;
+} RectArgs;
+
+typedef struct
+{
+    s32 x, y, a, b;
+} ElliArgs;
+
+typedef struct
+{
+    float x0, y0, x1, y1;
+} LineArgs;
+
+typedef struct
+{
+    float x1, y1, x2, y2, x3, y3;
+} TriArgs;
+
+typedef struct
+{
+    float x[3], y[3], u[3], v[3], z[3];
+    u8 mapping[TIC_PALETTE_SIZE];
+    u8 texsrc;
+    bool depth;
+} TtriArgs;
+
+typedef struct
+{
+    s32 index, x, y, w, h, scale;
+    u8 flip, rotate;
+    u8 mapping[TIC_PALETTE_SIZE];
+} SprArgs;
+
+typedef struct
+{
+    s32 x, y, width, height, sx, sy, scale;
+    u8 mapping[TIC_PALETTE_SIZE];
+} MapArgs;
+
+// followed by the text
+typedef struct
+{
+    s32 x, y, width, height, scale;
+    u8 segment;
+    bool fixed, alt;
+    u8 mapping[TIC_PALETTE_SIZE];
+} TextArgs;
 
 static tic_tilesheet getTileSheetFromSegment(tic_mem* memory, u8 segment)
 {
@@ -47,9 +129,8 @@ static tic_tilesheet getTileSheetFromSegment(tic_mem* memory, u8 segment)
     return tic_tilesheet_get(segment, src);
 }
 
-static u8* getPalette(tic_mem* tic, u8* colors, u8 count)
+static u8* getPalette(tic_mem* tic, u8* mapping, const u8* colors, u8 count)
 {
-    static u8 mapping[TIC_PALETTE_SIZE];
     for (s32 i = 0; i < TIC_PALETTE_SIZE; i++) mapping[i] = tic_tool_peek4(tic->ram->vram.mapping, i);
     for (s32 i = 0; i < count; i++) mapping[colors[i]] = TRANSPARENT_COLOR;
     return mapping;
@@ -60,19 +141,17 @@ static inline u8 mapColor(tic_mem* tic, u8 color)
     return tic_tool_peek4(tic->ram->vram.mapping, color & 0xf);
 }
 
-static inline void setPixel(tic_core* core, s32 x, s32 y, u8 color)
+static inline void setPixelFast(tic_core* core, s32 x, s32 y, u8 color)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-
-    if (x < core->state.clip.l || y < core->state.clip.t || x >= core->state.clip.r || y >= core->state.clip.b) return;
-
-    tic_api_poke4((tic_mem*)core, y * TIC80_WIDTH + x, color);
+    // does not do any CLIP checking, the caller needs to do that first
+    tic_tool_poke4(core->memory.ram->vram.screen.data, y * TIC80_WIDTH + x, color);
 }
 
-static inline void setPixelFast(tic_core* core, s32 x, s32 y, u8 color)
+static inline void setPixel(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, u8 color)
 {
-    // does not do any CLIP checking, the caller needs to do that first
-    tic_api_poke4((tic_mem*)core, y * TIC80_WIDTH + x, color);
+    if (x < clip->l || y < clip->t || x >= clip->r || y >= clip->b) return;
+
+    setPixelFast(core, x, y, color);
 }
 
 static u8 getPixel(tic_core* core, s32 x, s32 y)
@@ -82,54 +161,57 @@ static u8 getPixel(tic_core* core, s32 x, s32 y)
         : tic_api_peek4((tic_mem*)core, y * TIC80_WIDTH + x);
 }
 
-#define EARLY_CLIP(x, y, width, height) \
+// the rows of the band inside the clip
+static inline struct ClipRect bandClip(const struct ClipRect* clip, const struct ClipRect* rows)
+{
+    s32 t = MAX(clip->t, rows->t);
+    return (struct ClipRect){clip->l, t, clip->r, MAX(t, MIN(clip->b, rows->b))};
+}
+
+#define EARLY_CLIP(clip, x, y, width, height) \
     ( \
-        (((y)+(height)-1) < core->state.clip.t) \
-        || (((x)+(width)-1) < core->state.clip.l) \
-        || ((y) >= core->state.clip.b) \
-        || ((x) >= core->state.clip.r) \
+        (((y)+(height)-1) < (clip)->t) \
+        || (((x)+(width)-1) < (clip)->l) \
+        || ((y) >= (clip)->b) \
+        || ((x) >= (clip)->r) \
     )
 
-static void drawHLine(tic_core* core, s32 x, s32 y, s32 width, u8 color)
+static void drawHLine(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, s32 width, u8 color)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-
-    if (y < core->state.clip.t || core->state.clip.b <= y) return;
+    if (y < clip->t || clip->b <= y) return;
 
-    s32 xl = MAX(x, core->state.clip.l);
-    s32 xr = MIN(x + width, core->state.clip.r);
+    s32 xl = MAX(x, clip->l);
+    s32 xr = MIN(x + width, clip->r);
     s32 start = y * TIC80_WIDTH;
 
     for(s32 i = start + xl, end = start + xr; i < end; ++i)
-        tic_api_poke4((tic_mem*)core, i, color);
+        tic_tool_poke4(core->memory.ram->vram.screen.data, i, color);
 }
 
-static void drawVLine(tic_core* core, s32 x, s32 y, s32 height, u8 color)
+static void drawVLine(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, s32 height, u8 color)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-
-    if (x < core->state.clip.l || core->state.clip.r <= x) return;
+    if (x < clip->l || clip->r <= x) return;
 
     s32 yl = y < 0 ? 0 : y;
     s32 yr = y + height >= TIC80_HEIGHT ? TIC80_HEIGHT : y + height;
 
     for (s32 i = yl; i < yr; ++i)
-        setPixel(core, x, i, color);
+        setPixel(core, clip, x, i, color);
 }
 
-static void drawRect(tic_core* core, s32 x, s32 y, s32 width, s32 height, u8 color)
+static void drawRect(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, s32 width, s32 height, u8 color)
 {
     for (s32 i = y; i < y + height; ++i)
-        drawHLine(core, x, i, width, color);
+        drawHLine(core, clip, x, i, width, color);
 }
 
-static void drawRectBorder(tic_core* core, s32 x, s32 y, s32 width, s32 height, u8 color)
+static void drawRectBorder(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, s32 width, s32 height, u8 color)
 {
-    drawHLine(core, x, y, width, color);
-    drawHLine(core, x, y + height - 1, width, color);
+    drawHLine(core, clip, x, y, width, color);
+    drawHLine(core, clip, x, y + height - 1, width, color);
 
-    drawVLine(core, x, y, height, color);
-    drawVLine(core, x + width - 1, y, height, color);
+    drawVLine(core, clip, x, y, height, color);
+    drawVLine(core, clip, x + width - 1, y, height, color);
 }
 
 #define DRAW_TILE_BODY(X, Y) do {\
@@ -146,11 +228,8 @@ static void drawRectBorder(tic_core* core, s32 x, s32 y, s32 width, s32 height,
 
 #define REVERT(X) (TIC_SPRITESIZE - 1 - (X))
 
-static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
+static void drawTile(tic_core* core, const struct ClipRect* clip, tic_tileptr* tile, s32 x, s32 y, const u8* mapping, s32 scale, tic_flip flip, tic_rotate rotate)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-    u8* mapping = getPalette(&core->memory, colors, count);
-
     rotate &= 3;
     u32 orientation = flip & 3;
 
@@ -162,10 +241,10 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
     if (scale == 1) {
         // the most common path
         s32 sx, sy, ex, ey;
-        sx = core->state.clip.l - x; if (sx < 0) sx = 0;
-        sy = core->state.clip.t - y; if (sy < 0) sy = 0;
-        ex = core->state.clip.r - x; if (ex > TIC_SPRITESIZE) ex = TIC_SPRITESIZE;
-        ey = core->state.clip.b - y; if (ey > TIC_SPRITESIZE) ey = TIC_SPRITESIZE;
+        sx = clip->l - x; if (sx < 0) sx = 0;
+        sy = clip->t - y; if (sy < 0) sy = 0;
+        ex = clip->r - x; if (ex > TIC_SPRITESIZE) ex = TIC_SPRITESIZE;
+        ey = clip->b - y; if (ey > TIC_SPRITESIZE) ey = TIC_SPRITESIZE;
         y += sy;
         x += sx;
         switch (orientation) {
@@ -181,7 +260,7 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
         return;
     }
 
-    if (EARLY_CLIP(x, y, TIC_SPRITESIZE * scale, TIC_SPRITESIZE * scale)) return;
+    if (EARLY_CLIP(clip, x, y, TIC_SPRITESIZE * scale, TIC_SPRITESIZE * scale)) return;
 
     for (s32 py = 0; py < TIC_SPRITESIZE; py++, y += scale)
     {
@@ -194,7 +273,9 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
                 s32 tmp = ix; ix = iy; iy = tmp;
             }
             u8 color = mapping[tic_tilesheet_gettilepix(tile, ix, iy)];
-            if (color != TRANSPARENT_COLOR) drawRect(core, xx, y, scale, scale, color);
+            if (color != TRANSPARENT_COLOR)
+                for (s32 i = y; i < y + scale; ++i)
+                    drawHLine(core, clip, xx, i, scale, color);
         }
     }
 }
@@ -202,10 +283,8 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
 #undef DRAW_TILE_BODY
 #undef REVERT
 
-static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
+static void drawSprite(tic_core* core, const struct ClipRect* clip, s32 index, s32 x, s32 y, s32 w, s32 h, const u8* mapping, s32 scale, tic_flip flip, tic_rotate rotate)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-
     if (index < 0)
         return;
 
@@ -215,7 +294,7 @@ static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8
     tic_tilesheet sheet = getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment);
     if (w == 1 && h == 1) {
         tic_tileptr tile = tic_tilesheet_gettile(&sheet, index, false);
-        drawTile(core, &tile, x, y, colors, count, scale, flip, rotate);
+        drawTile(core, clip, &tile, x, y, mapping, scale, flip, rotate);
     }
     else
     {
@@ -224,7 +303,10 @@ static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8
 
         const tic_flip vert_horz_flip = tic_horz_flip | tic_vert_flip;
 
-        if (EARLY_CLIP(x, y, w * step, h * step)) return;
+        // the rotated sprite is laid out transposed
+        if (rotate == tic_90_rotate || rotate == tic_270_rotate
+            ? EARLY_CLIP(clip, x, y, h * step, w * step)
+            : EARLY_CLIP(clip, x, y, w * step, h * step)) return;
 
         for (s32 i = 0; i < w; i++)
         {
@@ -257,22 +339,35 @@ static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8
 
                 tic_tileptr tile = tic_tilesheet_gettile(&sheet, index + mx + my * cols, false);
                 if (rotate == 0 || rotate == 2)
-                    drawTile(core, &tile, x + i * step, y + j * step, colors, count, scale, flip, rotate);
+                    drawTile(core, clip, &tile, x + i * step, y + j * step, mapping, scale, flip, rotate);
                 else
-                    drawTile(core, &tile, x + j * step, y + i * step, colors, count, scale, flip, rotate);
+                    drawTile(core, clip, &tile, x + j * step, y + i * step, mapping, scale, flip, rotate);
             }
         }
     }
 }
 
-static void drawMap(tic_core* core, const tic_map* src, s32 x, s32 y, s32 width, s32 height, s32 sx, s32 sy, u8* colors, s32 count, s32 scale, RemapFunc remap, void* data)
+typedef struct
 {
-    const s32 size = TIC_SPRITESIZE * scale;
+    tic_core* core;
+    const struct ClipRect* clip;
+    const tic_map* src;
+    tic_tilesheet sheet;
+    const u8* mapping;
+    s32 x, y, width, height, sx, sy, scale;
+    RemapFunc remap;
+    void* data;
+} MapJob;
 
-    tic_tilesheet sheet = getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment);
+static void drawMapRows(const MapJob* job, const struct ClipRect* clip)
+{
+    const s32 size = TIC_SPRITESIZE * job->scale;
 
-    for (s32 j = y, jj = sy; j < y + height; j++, jj += size)
-        for (s32 i = x, ii = sx; i < x + width; i++, ii += size)
+    for (s32 j = job->y, jj = job->sy; j < job->y + job->height; j++, jj += size)
+    {
+        if (jj + size <= clip->t || jj >= clip->b) continue;
+
+        for (s32 i = job->x, ii = job->sx; i < job->x + job->width; i++, ii += size)
         {
             s32 mi = i;
             s32 mj = j;
@@ -283,20 +378,60 @@ static void drawMap(tic_core* core, const tic_map* src, s32 x, s32 y, s32 width,
             while (mj >= TIC_MAP_HEIGHT) mj -= TIC_MAP_HEIGHT;
 
             s32 index = mi + mj * TIC_MAP_WIDTH;
-            RemapResult retile = { *(src->data + index), tic_no_flip, tic_no_rotate };
+            RemapResult retile = { *(job->src->data + index), tic_no_flip, tic_no_rotate };
 
-            if (remap)
-                remap(data, mi, mj, &retile);
+            if (job->remap)
+                job->remap(job->data, mi, mj, &retile);
 
-            tic_tileptr tile = tic_tilesheet_gettile(&sheet, retile.index, true);
-            drawTile(core, &tile, ii, jj, colors, count, scale, retile.flip, retile.rotate);
+            tic_tileptr tile = tic_tilesheet_gettile(&job->sheet, retile.index, true);
+            drawTile(job->core, clip, &tile, ii, jj, job->mapping, job->scale, retile.flip, retile.rotate);
         }
+    }
 }
 
-static s32 drawChar(tic_core* core, tic_tileptr* font_char, s32 x, s32 y, s32 scale, bool fixed, u8* mapping)
+static void drawMapBand(void* data, s32 band, s32 count)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
+    const MapJob* job = data;
+    const struct ClipRect* clip = job->clip;
+    s32 height = clip->b - clip->t;
 
+    drawMapRows(job, &(struct ClipRect)
+    {
+        clip->l, 
+        clip->t + height * band / count, 
+        clip->r, 
+        clip->t + height * (band + 1) / count
+    });
+}
+
+// the rows are given when it's a band of the deferred calls
+static void drawMap(tic_core* core, const struct ClipRect* clip, const struct ClipRect* rows, const MapArgs* args, RemapFunc remap, void* data)
+{
+    MapJob job =
+    {
+        core, clip, &core->memory.ram->map,
+        getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment),
+        args->mapping,
+        args->x, args->y, args->width, args->height, args->sx, args->sy, args->scale,
+        remap, data
+    };
+
+    s32 size = TIC_SPRITESIZE * args->scale;
+
+    if (rows)
+    {
+        const struct ClipRect area = bandClip(clip, rows);
+        drawMapRows(&job, &area);
+    }
+    // remap calls the script, it has to stay on this thread
+    else if (core->jobs && !remap && (s64)args->width * args->height * size * size >= TIC_JOBS_MIN_AREA)
+        tic_jobs_run(core->jobs, drawMapBand, &job, tic_jobs_threads(core->jobs));
+    else
+        drawMapRows(&job, clip);
+}
+
+static s32 drawChar(tic_core* core, const struct ClipRect* clip, tic_tileptr* font_char, s32 x, s32 y, s32 scale, bool fixed, const u8* mapping)
+{
     enum { Size = TIC_SPRITESIZE };
 
     s32 j = 0, start = 0, end = Size;
@@ -315,7 +450,7 @@ static s32 drawChar(tic_core* core, tic_tileptr* font_char, s32 x, s32 y, s32 sc
     }
     s32 width = end - start;
 
-    if (EARLY_CLIP(x, y, Size * scale, Size * scale)) return width;
+    if (EARLY_CLIP(clip, x, y, Size * scale, Size * scale)) return width;
 
     s32 colStart = start, colStep = 1, rowStart = 0, rowStep = 1;
 
@@ -325,13 +460,13 @@ static s32 drawChar(tic_core* core, tic_tileptr* font_char, s32 x, s32 y, s32 sc
         {
             u8 color = tic_tilesheet_gettilepix(font_char, col, row);
             if (mapping[color] != TRANSPARENT_COLOR)
-                drawRect(core, xs, ys, scale, scale, mapping[color]);
+                drawRect(core, clip, xs, ys, scale, scale, mapping[color]);
         }
     }
     return width;
 }
 
-static s32 drawText(tic_core* core, tic_tilesheet* font_face, const char* text, s32 x, s32 y, s32 width, s32 height, bool fixed, u8* mapping, s32 scale, bool alt)
+static s32 drawText(tic_core* core, const struct ClipRect* clip, tic_tilesheet* font_face, const char* text, s32 x, s32 y, s32 width, s32 height, bool fixed, const u8* mapping, s32 scale, bool alt)
 {
     s32 pos = x;
     s32 MAX = x;
@@ -349,7 +484,7 @@ static s32 drawText(tic_core* core, tic_tilesheet* font_face, const char* text,
         }
         else {
             tic_tileptr font_char = tic_tilesheet_gettile(font_face, alt * TIC_FONT_CHARS + sym, true);
-            s32 size = drawChar(core, &font_char, pos, y, scale, fixed, mapping);
+            s32 size = drawChar(core, clip, &font_char, pos, y, scale, fixed, mapping);
             pos += ((!fixed && size) ? size + 1 : width) * scale;
         }
     }
@@ -357,148 +492,65 @@ static s32 drawText(tic_core* core, tic_tilesheet* font_face, const char* text,
     return pos > MAX ? pos - x : MAX - x;
 }
 
-void tic_api_clip(tic_mem* memory, s32 x, s32 y, s32 width, s32 height)
-{
-    tic_core* core = (tic_core*)memory;
-    tic_vram* vram = &memory->ram->vram;
-
-    core->state.clip.l = x;
-    core->state.clip.t = y;
-    core->state.clip.r = x + width;
-    core->state.clip.b = y + height;
-
-    if (core->state.clip.l < 0) core->state.clip.l = 0;
-    if (core->state.clip.t < 0) core->state.clip.t = 0;
-    if (core->state.clip.r > TIC80_WIDTH) core->state.clip.r = TIC80_WIDTH;
-    if (core->state.clip.b > TIC80_HEIGHT) core->state.clip.b = TIC80_HEIGHT;
-}
-
-void tic_api_rect(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, u8 color)
-{
-    tic_core* core = (tic_core*)memory;
-
-    drawRect(core, x, y, width, height, mapColor(memory, color));
-}
-
 static double ZBuffer[TIC80_WIDTH * TIC80_HEIGHT];
 
-void tic_api_cls(tic_mem* tic, u8 color)
+static void drawCls(tic_core* core, const struct ClipRect* clip, u8 color)
 {
-    tic_core* core = (tic_core*)tic;
-    tic_vram* vram = &tic->ram->vram;
-
-    static const struct ClipRect EmptyClip = { 0, 0, TIC80_WIDTH, TIC80_HEIGHT };
+    tic_vram* vram = &core->memory.ram->vram;
 
-    color = mapColor(tic, color);
+    enum { RowSize = TIC80_WIDTH * TIC_PALETTE_BPP / BITS_IN_BYTE };
 
-    if (MEMCMP(core->state.clip, EmptyClip))
+    // the whole rows are cleared at once
+    if (clip->l == 0 && clip->r == TIC80_WIDTH)
     {
-        memset(&vram->screen, (color & 0xf) | (color << TIC_PALETTE_BPP), sizeof(tic_screen));
-        ZEROMEM(ZBuffer);
+        s32 rows = clip->b - clip->t;
+
+        if (rows > 0)
+        {
+            memset(vram->screen.data + clip->t * RowSize, (color & 0xf) | (color << TIC_PALETTE_BPP), rows * RowSize);
+            memset(ZBuffer + clip->t * TIC80_WIDTH, 0, rows * TIC80_WIDTH * sizeof *ZBuffer);
+        }
     }
     else
     {
-        for(s32 y = core->state.clip.t, start = y * TIC80_WIDTH; y < core->state.clip.b; ++y, start += TIC80_WIDTH)
-            for(s32 x = core->state.clip.l, pixel = start + x; x < core->state.clip.r; ++x, ++pixel)
+        for(s32 y = clip->t, start = y * TIC80_WIDTH; y < clip->b; ++y, start += TIC80_WIDTH)
+            for(s32 x = clip->l, pixel = start + x; x < clip->r; ++x, ++pixel)
             {
-                tic_api_poke4(tic, pixel, color);
+                tic_tool_poke4(vram->screen.data, pixel, color);
                 ZBuffer[pixel] = 0;
             }
     }
 }
 
-s32 tic_api_font(tic_mem* memory, const char* text, s32 x, s32 y, u8* trans_colors, u8 trans_count, s32 w, s32 h, bool fixed, s32 scale, bool alt)
-{
-    u8* mapping = getPalette(memory, trans_colors, trans_count);
-
-    // Compatibility : flip top and bottom of the spritesheet
-    // to preserve tic_api_font's default target
-    u8 segment = memory->ram->vram.blit.segment >> 1;
-    u8 flipmask = 1; while (segment >>= 1) flipmask <<= 1;
-
-    tic_tilesheet font_face = getTileSheetFromSegment(memory, memory->ram->vram.blit.segment ^ flipmask);
-    return drawText((tic_core*)memory, &font_face, text, x, y, w, h, fixed, mapping, scale, alt);
-}
-
-s32 tic_api_print(tic_mem* memory, const char* text, s32 x, s32 y, u8 color, bool fixed, s32 scale, bool alt)
-{
-    u8 mapping[] = { 255, color };
-    tic_tilesheet font_face = getTileSheetFromSegment(memory, 1);
-
-    const tic_font_data* font = alt ? &memory->ram->font.alt : &memory->ram->font.regular;
-    s32 width = font->width;
-
-    // Compatibility : print uses reduced width for non-fixed space
-    if (!fixed) width -= 2;
-    return drawText((tic_core*)memory, &font_face, text, x, y, width, font->height, fixed, mapping, scale, alt);
-}
-
-void tic_api_spr(tic_mem* memory, s32 index, s32 x, s32 y, s32 w, s32 h, u8* trans_colors, u8 trans_count, s32 scale, tic_flip flip, tic_rotate rotate)
-{
-    drawSprite((tic_core*)memory, index, x, y, w, h, trans_colors, trans_count, scale, flip, rotate);
-}
-
-static inline u8* getFlag(tic_mem* memory, s32 index, u8 flag)
-{
-    static u8 stub = 0;
-    if (index >= TIC_FLAGS || flag >= BITS_IN_BYTE)
-        return &stub;
-
-    return memory->ram->flags.data + index;
-}
-
-bool tic_api_fget(tic_mem* memory, s32 index, u8 flag)
-{
-    return *getFlag(memory, index, flag) & (1 << flag);
-}
-
-void tic_api_fset(tic_mem* memory, s32 index, u8 flag, bool value)
-{
-    if (value)
-        *getFlag(memory, index, flag) |= (1 << flag);
-    else
-        *getFlag(memory, index, flag) &= ~(1 << flag);
-}
-
-u8 tic_api_pix(tic_mem* memory, s32 x, s32 y, u8 color, bool get)
-{
-    tic_core* core = (tic_core*)memory;
-
-    if (get) return getPixel(core, x, y);
-
-    setPixel(core, x, y, mapColor(memory, color));
-    return 0;
-}
-
-void tic_api_rectb(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, u8 color)
-{
-    tic_core* core = (tic_core*)memory;
-
-    drawRectBorder(core, x, y, width, height, mapColor(memory, color));
-}
-
-static struct
+typedef struct
 {
     s16 Left[TIC80_HEIGHT];
     s16 Right[TIC80_HEIGHT];
-} SidesBuffer;
+} Sides;
 
-static void initSidesBuffer()
+// the outline of the ellipse is drawn to the clipped screen
+typedef struct
 {
-    for (s32 i = 0; i < COUNT_OF(SidesBuffer.Left); i++)
-        SidesBuffer.Left[i] = TIC80_WIDTH, SidesBuffer.Right[i] = -1;
+    tic_core* core;
+    const struct ClipRect* clip;
+} PixelTarget;
+
+static void initSides(Sides* sides)
+{
+    for (s32 i = 0; i < COUNT_OF(sides->Left); i++)
+        sides->Left[i] = TIC80_WIDTH, sides->Right[i] = -1;
 }
 
-static void setSidePixel(s32 x, s32 y)
+static void setSidePixel(Sides* sides, s32 x, s32 y)
 {
     if (y >= 0 && y < TIC80_HEIGHT)
     {
-        if (x < SidesBuffer.Left[y]) SidesBuffer.Left[y] = x;
-        if (x > SidesBuffer.Right[y]) SidesBuffer.Right[y] = x;
+        if (x < sides->Left[y]) sides->Left[y] = x;
+        if (x > sides->Right[y]) sides->Right[y] = x;
     }
 }
 
-static void drawEllipse(tic_mem* memory, s32 x0, s32 y0, s32 x1, s32 y1, u8 color, PixelFunc pix)
+static void drawEllipse(void* data, s32 x0, s32 y0, s32 x1, s32 y1, u8 color, PixelFunc pix)
 {
     if(x0 > x1 || y0 > y1)
         return;
@@ -514,10 +566,10 @@ static void drawEllipse(tic_mem* memory, s32 x0, s32 y0, s32 x1, s32 y1, u8 colo
 
     do 
     {
-        pix(memory, x1, y0, color); /*   I. Quadrant */
-        pix(memory, x0, y0, color); /*  II. Quadrant */
-        pix(memory, x0, y1, color); /* III. Quadrant */
-        pix(memory, x1, y1, color); /*  IV. Quadrant */
+        pix(data, x1, y0, color); /*   I. Quadrant */
+        pix(data, x0, y0, color); /*  II. Quadrant */
+        pix(data, x0, y1, color); /* III. Quadrant */
+        pix(data, x1, y1, color); /*  IV. Quadrant */
         e2 = 2 * err;
         if (e2 <= dy) { y0++; y1--; err += dy += a; }  /* y step */ 
         if (e2 >= dx || 2 * err > dy) { x0++; x1--; err += dx += b1; } /* x step */
@@ -525,64 +577,50 @@ static void drawEllipse(tic_mem* memory, s32 x0, s32 y0, s32 x1, s32 y1, u8 colo
 
     while (y0-y1 < b) 
     {  /* too early stop of flat ellipses a=1 */
-        pix(memory, x0 - 1, y0,    color); /* -> finish tip of ellipse */
-        pix(memory, x1 + 1, y0++,  color); 
-        pix(memory, x0 - 1, y1,    color);
-        pix(memory, x1 + 1, y1--,  color); 
+        pix(data, x0 - 1, y0,    color); /* -> finish tip of ellipse */
+        pix(data, x1 + 1, y0++,  color); 
+        pix(data, x0 - 1, y1,    color);
+        pix(data, x1 + 1, y1--,  color); 
     }
 }
 
-static void setElliPixel(tic_mem* tic, s32 x, s32 y, u8 color)
+static void setElliPixel(void* data, s32 x, s32 y, u8 color)
 {
-    setPixel((tic_core*)tic, x, y, color);
+    const PixelTarget* target = data;
+    setPixel(target->core, target->clip, x, y, color);
 }
 
-static void setElliSide(tic_mem* tic, s32 x, s32 y, u8 color)
+static void setElliSide(void* data, s32 x, s32 y, u8 color)
 {
-    setSidePixel(x, y);
+    setSidePixel(data, x, y);
 }
 
-static void drawSidesBuffer(tic_mem* memory, s32 y0, s32 y1, u8 color)
+static void drawSides(tic_core* core, const struct ClipRect* clip, const Sides* sides, s32 y0, s32 y1, u8 color)
 {
-    tic_vram* vram = &memory->ram->vram;
-
-    tic_core* core = (tic_core*)memory;
-    s32 yt = MAX(core->state.clip.t, y0);
-    s32 yb = MIN(core->state.clip.b, y1 + 1);
-    u8 final_color = mapColor(&core->memory, color);
+    s32 yt = MAX(clip->t, y0);
+    s32 yb = MIN(clip->b, y1 + 1);
     for (s32 y = yt; y < yb; y++) 
     {
-        s32 xl = MAX(SidesBuffer.Left[y], core->state.clip.l);
-        s32 xr = MIN(SidesBuffer.Right[y] + 1, core->state.clip.r);
+        s32 xl = MAX(sides->Left[y], clip->l);
+        s32 xr = MIN(sides->Right[y] + 1, clip->r);
         s32 start = y * TIC80_WIDTH;
 
         for(s32 i = start + xl, end = start + xr; i < end; ++i)
-            tic_api_poke4(memory, i, color);
+            tic_tool_poke4(core->memory.ram->vram.screen.data, i, color);
     }
 }
 
-void tic_api_circ(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
-{
-    initSidesBuffer();
-    drawEllipse(memory, x - r, y - r, x + r, y + r, 0, setElliSide);
-    drawSidesBuffer(memory, y - r, y + r + 1, mapColor(memory, color));
-}
-
-void tic_api_circb(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
-{
-    drawEllipse(memory, x - r, y - r, x + r, y + r, mapColor(memory, color), setElliPixel);
-}
-
-void tic_api_elli(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
+static void drawFilledEllipse(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, s32 a, s32 b, u8 color)
 {
-    initSidesBuffer();
-    drawEllipse(memory, x - a, y - b, x + a, y + b, 0, setElliSide);
-    drawSidesBuffer(memory, y - b, y + b + 1, mapColor(memory, color));
+    Sides sides;
+    initSides(&sides);
+    drawEllipse(&sides, x - a, y - b, x + a, y + b, 0, setElliSide);
+    drawSides(core, clip, &sides, y - b, y + b + 1, color);
 }
 
-void tic_api_ellib(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
+static void drawEllipseBorder(tic_core* core, const struct ClipRect* clip, s32 x, s32 y, s32 a, s32 b, u8 color)
 {
-    drawEllipse(memory, x - a, y - b, x + a, y + b, mapColor(memory, color), setElliPixel);
+    drawEllipse(&(PixelTarget){core, clip}, x - a, y - b, x + a, y + b, color, setElliPixel);
 }
 
 static inline float initLine(float *x0, float *x1, float *y0, float *y1)
@@ -601,16 +639,16 @@ static inline float initLine(float *x0, float *x1, float *y0, float *y1)
     return t;
 }
 
-static void drawLine(tic_mem* tic, float x0, float y0, float x1, float y1, u8 color)
+static void drawLine(tic_core* core, const struct ClipRect* clip, float x0, float y0, float x1, float y1, u8 color)
 {
     if(fabs(x0 - x1) < fabs(y0 - y1))
         for (float t = initLine(&x0, &x1, &y0, &y1); y0 < y1; y0++, x0 += t)
-            setPixel((tic_core*)tic, x0, y0, color);
+            setPixel(core, clip, x0, y0, color);
     else
         for (float t = initLine(&y0, &y1, &x0, &x1); x0 < x1; x0++, y0 += t)
-            setPixel((tic_core*)tic, x0, y0, color);
+            setPixel(core, clip, x0, y0, color);
 
-    setPixel((tic_core*)tic, x1, y1, color);
+    setPixel(core, clip, x1, y1, color);
 }
 
 typedef union
@@ -647,12 +685,61 @@ static inline double edgeFn(const Vec2* a, const Vec2* b, const Vec2* c)
     return (b->x - a->x) * (c->y - a->y) - (b->y - a->y) * (c->x - a->x);
 }
 
-static void drawTri(tic_mem* tic, const Vec2* v0, const Vec2* v1, const Vec2* v2, PixelShader shader, void* data)
+typedef struct
 {
-    ShaderAttr a = {data, v0, v1, v2};
+    tic_core* core;
+    ShaderAttr a;
+    PixelShader shader;
+    tic_point min, max;
+    Vec2 d[3];
+    Vec3 s;
+} TriJob;
 
-    tic_core* core = (tic_core*)tic;
-    const struct ClipRect* clip = &core->state.clip;
+static void drawTriRows(const TriJob* job, s32 top, s32 bottom)
+{
+    ShaderAttr a = job->a;
+    Vec3 s = job->s;
+
+    // the edge functions are stepped to the first row of the band
+    // row by row, the band pixels match the whole triangle ones
+    for(s32 y = job->min.y; y < top; ++y)
+        for(s32 i = 0; i != COUNT_OF(s.d); ++i)
+            s.d[i] += job->d[i].y;
+
+    for(s32 y = top, start = top * TIC80_WIDTH + job->min.x; y < bottom; ++y, start += TIC80_WIDTH)
+    {
+        for(s32 i = 0; i != COUNT_OF(a.w.d); ++i)
+            a.w.d[i] = s.d[i];
+
+        for(s32 x = job->min.x, pixel = start; x < job->max.x; ++x, ++pixel)
+        {
+            if(a.w.x > -DBL_EPSILON && a.w.y > -DBL_EPSILON && a.w.z > -DBL_EPSILON)
+            {
+                u8 color = job->shader(&a, pixel);
+                if(color != TRANSPARENT_COLOR)
+                    tic_tool_poke4(job->core->memory.ram->vram.screen.data, pixel, color);
+            }
+
+            for(s32 i = 0; i != COUNT_OF(a.w.d); ++i)
+                a.w.d[i] += job->d[i].x;
+        }
+
+        for(s32 i = 0; i != COUNT_OF(s.d); ++i)
+            s.d[i] += job->d[i].y;
+    }
+}
+
+static void drawTriBand(void* data, s32 band, s32 count)
+{
+    const TriJob* job = data;
+    s32 height = job->max.y - job->min.y;
+
+    drawTriRows(job, job->min.y + height * band / count, job->min.y + height * (band + 1) / count);
+}
+
+static bool initTri(TriJob* job, tic_core* core, const struct ClipRect* clip, const Vec2* v0, const Vec2* v1, const Vec2* v2, PixelShader shader, void* data)
+{
+    ShaderAttr a = {data, v0, v1, v2};
 
     tic_point min = {floor(MIN3(a.v[0]->x, a.v[1]->x, a.v[2]->x)), floor(MIN3(a.v[0]->y, a.v[1]->y, a.v[2]->y))};
     tic_point max = {ceil(MAX3(a.v[0]->x, a.v[1]->x, a.v[2]->x)), ceil(MAX3(a.v[0]->y, a.v[1]->y, a.v[2]->y))};
@@ -662,78 +749,52 @@ static void drawTri(tic_mem* tic, const Vec2* v0, const Vec2* v1, const Vec2* v2
     max.x = MIN(max.x, clip->r);
     max.y = MIN(max.y, clip->b);
 
-    if(min.x >= max.x || min.y >= max.y) return;
+    if(min.x >= max.x || min.y >= max.y) return false;
 
     double area = edgeFn(a.v[0], a.v[1], a.v[2]);
-    if((s32)floor(area) == 0) return;
+    if((s32)floor(area) == 0) return false;
     if(area < 0.0)
     {
         SWAP(a.v[1], a.v[2], const Vec2*);
         area = -area;
     }
 
-    Vec2 d[3];
-    Vec3 s;
+    *job = (TriJob){core, a, shader, min, max};
 
-    for(s32 i = 0; i != COUNT_OF(s.d); ++i)
+    for(s32 i = 0; i != COUNT_OF(job->s.d); ++i)
     {
         // pixel center
         const double Center = 0.5 - FLT_EPSILON;
         Vec2 p = {min.x + Center, min.y + Center};
 
         s32 c = (i + 1) % 3, n = (i + 2) % 3;
-        
-        d[i].x = (a.v[c]->y - a.v[n]->y) / area;
-        d[i].y = (a.v[n]->x - a.v[c]->x) / area;
-        s.d[i] = edgeFn(a.v[c], a.v[n], &p) / area;
-    }
-
-    for(s32 y = min.y, start = min.y * TIC80_WIDTH + min.x; y < max.y; ++y, start += TIC80_WIDTH)
-    {
-        for(s32 i = 0; i != COUNT_OF(a.w.d); ++i)
-            a.w.d[i] = s.d[i];
 
-        for(s32 x = min.x, pixel = start; x < max.x; ++x, ++pixel)
-        {
-            if(a.w.x > -DBL_EPSILON && a.w.y > -DBL_EPSILON && a.w.z > -DBL_EPSILON)
-            {
-                u8 color = shader(&a, pixel);
-                if(color != TRANSPARENT_COLOR)
-                    tic_api_poke4(tic, pixel, color);
-            }
-
-            for(s32 i = 0; i != COUNT_OF(a.w.d); ++i)
-                a.w.d[i] += d[i].x;
-        }
-
-        for(s32 i = 0; i != COUNT_OF(s.d); ++i)
-            s.d[i] += d[i].y;
+        job->d[i].x = (a.v[c]->y - a.v[n]->y) / area;
+        job->d[i].y = (a.v[n]->x - a.v[c]->x) / area;
+        job->s.d[i] = edgeFn(a.v[c], a.v[n], &p) / area;
     }
-}
 
-static tic_color triColorShader(const ShaderAttr* a, s32 pixel){return *(u8*)a->data;}
-
-void tic_api_tri(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3, u8 color)
-{
-    color = mapColor(tic, color);
-    drawTri(tic,
-        &(Vec2){x1, y1},
-        &(Vec2){x2, y2},
-        &(Vec2){x3, y3}, 
-        triColorShader, &color);
+    return true;
 }
 
-void tic_api_trib(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3, u8 color)
+// the triangle is set up with the whole clip for the bands of the deferred calls,
+// only the rows are limited to keep the pixels the same as in the immediate mode
+static void drawTri(tic_core* core, const struct ClipRect* clip, const struct ClipRect* rows, const Vec2* v0, const Vec2* v1, const Vec2* v2, PixelShader shader, void* data)
 {
-    tic_core* core = (tic_core*)tic;
+    TriJob job;
 
-    u8 finalColor = mapColor(tic, color);
+    if(!initTri(&job, core, clip, v0, v1, v2, shader, data)) return;
 
-    drawLine(tic, x1, y1, x2, y2, finalColor);
-    drawLine(tic, x2, y2, x3, y3, finalColor);
-    drawLine(tic, x3, y3, x1, y1, finalColor);
+    if(rows)
+        drawTriRows(&job, MAX(job.min.y, rows->t), MIN(job.max.y, rows->b));
+    else if(core->jobs && (job.max.x - job.min.x) * (job.max.y - job.min.y) >= TIC_JOBS_MIN_AREA)
+        tic_jobs_run(core->jobs, drawTriBand, &job, tic_jobs_threads(core->jobs));
+    else
+        drawTriRows(&job, job.min.y, job.max.y);
 }
 
+static tic_color triColorShader(const ShaderAttr* a, s32 pixel){return *(u8*)a->data;}
+
 typedef struct
 {
     Vec2 _;
@@ -743,7 +804,7 @@ typedef struct
 typedef struct
 {
     tic_tilesheet sheet;
-    u8* mapping;
+    const u8* mapping;
     const u8* map;
     const tic_vram* vram;
     bool depth;
@@ -838,72 +899,506 @@ static tic_color triTexVbankShader(const ShaderAttr* a, s32 pixel)
     return shaderEnd(a, &vars, pixel, data->mapping[tic_tool_peek4(data->vram->data, iv * TIC80_WIDTH + iu)]);
 }
 
-void tic_api_ttri(tic_mem* tic, 
-    float x1, float y1, 
-    float x2, float y2, 
-    float x3, float y3, 
-    float u1, float v1, 
-    float u2, float v2, 
-    float u3, float v3, 
-    tic_texture_src texsrc, u8* colors, s32 count, 
-    float z1, float z2, float z3, bool depth)
+static const PixelShader TexShaders[] =
 {
-    // do not use depth if user passed z=0.0
-    if(z1 < FLT_EPSILON || z2 < FLT_EPSILON || z3 < FLT_EPSILON)
-        depth = false;
+    [tic_tiles_texture] = triTexTileShader,
+    [tic_map_texture]   = triTexMapShader,
+    [tic_vbank_texture] = triTexVbankShader,
+};
+
+static void drawTexTri(tic_core* core, const struct ClipRect* clip, const struct ClipRect* rows, const TtriArgs* args)
+{
+    tic_mem* tic = &core->memory;
 
     TexData texData = 
     {
         .sheet = getTileSheetFromSegment(tic, tic->ram->vram.blit.segment),
-        .mapping = getPalette(tic, colors, count),
+        .mapping = args->mapping,
         .map = tic->ram->map.data,
-        .vram = &((tic_core*)tic)->state.vbank.mem,
-        .depth = depth,
+        .vram = &core->state.vbank.mem,
+        .depth = args->depth,
     };
 
-    TexVert t[] = 
-    {
-        {x1, y1, u1, v1, z1},
-        {x2, y2, u2, v2, z2},
-        {x3, y3, u3, v3, z3},
-    };
+    TexVert t[3];
+
+    for(s32 i = 0; i != COUNT_OF(t); ++i)
+        t[i] = (TexVert){args->x[i], args->y[i], args->u[i], args->v[i], args->z[i]};
 
-    if(depth)
+    if(args->depth)
         for(s32 i = 0; i != COUNT_OF(t); ++i)
             t[i].d.x /= t[i].d.z, 
             t[i].d.y /= t[i].d.z, 
             t[i].d.z = 1.0 / t[i].d.z;
 
-    static const PixelShader Shaders[] = 
+    drawTri(core, clip, rows,
+        (const Vec2*)&t[0],
+        (const Vec2*)&t[1],
+        (const Vec2*)&t[2],
+        TexShaders[args->texsrc], &texData);
+}
+
+// draws the call to the clip, or to the rows of the clip when it's a band
+// of the deferred calls, the arguments are the same in both cases
+static void drawCommand(tic_core* core, const struct ClipRect* clip, const struct ClipRect* rows, u8 type, u8 color, const void* args)
+{
+    const struct ClipRect area = rows ? bandClip(clip, rows) : *clip;
+
+    switch(type)
     {
-        [tic_tiles_texture] = triTexTileShader,
-        [tic_map_texture]   = triTexMapShader,
-        [tic_vbank_texture] = triTexVbankShader,
-    };
-    
-    if(texsrc >= 0 && texsrc < COUNT_OF(Shaders))
-        drawTri(tic,
-            (const Vec2*)&t[0],
-            (const Vec2*)&t[1],
-            (const Vec2*)&t[2], 
-            Shaders[texsrc], &texData);
+    case DrawCls:
+        drawCls(core, &area, color);
+        break;
+    case DrawPix:
+        {
+            const PixArgs* a = args;
+            setPixel(core, &area, a->x, a->y, color);
+        }
+        break;
+    case DrawRect:
+        {
+            const RectArgs* a = args;
+            drawRect(core, &area, a->x, a->y, a->width, a->height, color);
+        }
+        break;
+    case DrawRectb:
+        {
+            const RectArgs* a = args;
+            drawRectBorder(core, &area, a->x, a->y, a->width, a->height, color);
+        }
+        break;
+    case DrawLine:
+        {
+            const LineArgs* a = args;
+            drawLine(core, &area, a->x0, a->y0, a->x1, a->y1, color);
+        }
+        break;
+    case DrawTri:
+        {
+            const TriArgs* a = args;
+            drawTri(core, clip, rows,
+                &(Vec2){a->x1, a->y1},
+                &(Vec2){a->x2, a->y2},
+                &(Vec2){a->x3, a->y3},
+                triColorShader, &color);
+        }
+        break;
+    case DrawTrib:
+        {
+            const TriArgs* a = args;
+            drawLine(core, &area, a->x1, a->y1, a->x2, a->y2, color);
+            drawLine(core, &area, a->x2, a->y2, a->x3, a->y3, color);
+            drawLine(core, &area, a->x3, a->y3, a->x1, a->y1, color);
+        }
+        break;
+    case DrawTtri:
+        drawTexTri(core, clip, rows, args);
+        break;
+    case DrawElli:
+        {
+            const ElliArgs* a = args;
+            drawFilledEllipse(core, &area, a->x, a->y, a->a, a->b, color);
+        }
+        break;
+    case DrawEllib:
+        {
+            const ElliArgs* a = args;
+            drawEllipseBorder(core, &area, a->x, a->y, a->a, a->b, color);
+        }
+        break;
+    case DrawSpr:
+        {
+            const SprArgs* a = args;
+            drawSprite(core, &area, a->index, a->x, a->y, a->w, a->h, a->mapping, a->scale, a->flip, a->rotate);
+        }
+        break;
+    case DrawMap:
+        drawMap(core, clip, rows, args, NULL, NULL);
+        break;
+    case DrawText:
+        {
+            const TextArgs* a = args;
+            tic_tilesheet font_face = getTileSheetFromSegment(&core->memory, a->segment);
+            drawText(core, &area, &font_face, (const char*)(a + 1), a->x, a->y, a->width, a->height, a->fixed, a->mapping, a->scale, a->alt);
+        }
+        break;
+    }
+}
+
+// returns the arguments of the recorded call to fill,
+// NULL when the call has to be drawn immediately
+static void* deferCommand(tic_core* core, u8 type, u8 color, u32 size)
+{
+    if(!core->deferred.recording)
+        return NULL;
+
+    size = (sizeof(DrawCmd) + size + sizeof(u64) - 1) & ~(sizeof(u64) - 1);
+
+    // the long lists are rasterized by parts
+    if(core->deferred.size + size > TIC_DEFERRED_BUFFER_MAX)
+        tic_core_draw_flush(&core->memory);
+
+    if(core->deferred.size + size > core->deferred.capacity)
+    {
+        u32 capacity = MAX(core->deferred.capacity, TIC_DEFERRED_BUFFER_SIZE);
+
+        while(capacity < core->deferred.size + size)
+            capacity *= 2;
+
+        u8* data = realloc(core->deferred.data, capacity);
+
+        if(!data)
+        {
+            tic_core_draw_flush(&core->memory);
+            return NULL;
+        }
+
+        core->deferred.data = data;
+        core->deferred.capacity = capacity;
+    }
+
+    if(!core->deferred.size)
+        core->deferred.clip = core->state.clip;
+
+    DrawCmd* cmd = (DrawCmd*)(core->deferred.data + core->deferred.size);
+    *cmd = (DrawCmd){type, color, size};
+    core->deferred.size += size;
+
+    return cmd + 1;
+}
+
+static void submitCommand(tic_core* core, u8 type, u8 color, const void* args, u32 size)
+{
+    void* cmd = deferCommand(core, type, color, size);
+
+    if(cmd)
+    {
+        if(size)
+            memcpy(cmd, args, size);
+    }
+    else
+        drawCommand(core, &core->state.clip, NULL, type, color, args);
+}
+
+// the text is measured when it's recorded, the width is returned to the script
+static s32 submitText(tic_core* core, u8 segment, const char* text, s32 x, s32 y, s32 width, s32 height, bool fixed, const u8* mapping, s32 scale, bool alt)
+{
+    static const struct ClipRect Measure = {0};
+
+    tic_tilesheet font_face = getTileSheetFromSegment(&core->memory, segment);
+    u32 length = (u32)strlen(text) + 1;
+    TextArgs* args = deferCommand(core, DrawText, 0, sizeof(TextArgs) + length);
+
+    if(!args)
+        return drawText(core, &core->state.clip, &font_face, text, x, y, width, height, fixed, mapping, scale, alt);
+
+    *args = (TextArgs){x, y, width, height, scale, segment, fixed, alt};
+    memcpy(args->mapping, mapping, sizeof args->mapping);
+    memcpy(args + 1, text, length);
+
+    return drawText(core, &Measure, &font_face, text, x, y, width, height, fixed, mapping, scale, alt);
+}
+
+static void drawDeferredBand(void* data, s32 band, s32 count)
+{
+    tic_core* core = data;
+
+    const struct ClipRect rows = {0, TIC80_HEIGHT * band / count, TIC80_WIDTH, TIC80_HEIGHT * (band + 1) / count};
+    struct ClipRect clip = core->deferred.clip;
+
+    for(const u8* ptr = core->deferred.data, *end = ptr + core->deferred.size; ptr < end;)
+    {
+        const DrawCmd* cmd = (const DrawCmd*)ptr;
+
+        if(cmd->type == DrawClip)
+            clip = *(const struct ClipRect*)(cmd + 1);
+        else
+            drawCommand(core, &clip, &rows, cmd->type, cmd->color, cmd + 1);
+
+        ptr += cmd->size;
+    }
+}
+
+void tic_core_draw_flush(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(!core->deferred.size)
+        return;
+
+    // the draw calls time their own flushes
+    u64 start = core->stats.active ? tic_core_stats_counter(core) : 0;
+
+    tic_jobs_run(core->jobs, drawDeferredBand, core, tic_jobs_threads(core->jobs) * TIC_DEFERRED_BANDS);
+    core->deferred.size = 0;
+
+    if(start)
+        core->stats.time.draw += tic_core_stats_counter(core) - start;
+}
+
+void tic_api_clip(tic_mem* memory, s32 x, s32 y, s32 width, s32 height)
+{
+    tic_core* core = (tic_core*)memory;
+    tic_vram* vram = &memory->ram->vram;
+
+    tic_core_stats_call(memory, tic_api_id_clip);
+
+    core->state.clip.l = x;
+    core->state.clip.t = y;
+    core->state.clip.r = x + width;
+    core->state.clip.b = y + height;
+
+    if (core->state.clip.l < 0) core->state.clip.l = 0;
+    if (core->state.clip.t < 0) core->state.clip.t = 0;
+    if (core->state.clip.r > TIC80_WIDTH) core->state.clip.r = TIC80_WIDTH;
+    if (core->state.clip.b > TIC80_HEIGHT) core->state.clip.b = TIC80_HEIGHT;
+
+    // the first recorded call takes the current clip
+    if (core->deferred.size)
+    {
+        struct ClipRect* clip = deferCommand(core, DrawClip, 0, sizeof(struct ClipRect));
+
+        if (clip)
+            *clip = core->state.clip;
+    }
+}
+
+void tic_api_rect(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, u8 color)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_stats_draw(memory, tic_api_id_rect);
+
+    submitCommand(core, DrawRect, mapColor(memory, color), &(RectArgs){x, y, width, height}, sizeof(RectArgs));
+
+    tic_core_stats_draw_end(memory, start);
+}
+
+void tic_api_cls(tic_mem* tic, u8 color)
+{
+    tic_core* core = (tic_core*)tic;
+
+    u64 start = tic_core_stats_draw(tic, tic_api_id_cls);
+
+    submitCommand(core, DrawCls, mapColor(tic, color), NULL, 0);
+
+    tic_core_stats_draw_end(tic, start);
+}
+
+s32 tic_api_font(tic_mem* memory, const char* text, s32 x, s32 y, u8* trans_colors, u8 trans_count, s32 w, s32 h, bool fixed, s32 scale, bool alt)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_font);
+    u8 mapping[TIC_PALETTE_SIZE];
+    getPalette(memory, mapping, trans_colors, trans_count);
+
+    // Compatibility : flip top and bottom of the spritesheet
+    // to preserve tic_api_font's default target
+    u8 segment = memory->ram->vram.blit.segment >> 1;
+    u8 flipmask = 1; while (segment >>= 1) flipmask <<= 1;
+
+    s32 width = submitText((tic_core*)memory, memory->ram->vram.blit.segment ^ flipmask, text, x, y, w, h, fixed, mapping, scale, alt);
+
+    tic_core_stats_draw_end(memory, start);
+    return width;
+}
+
+s32 tic_api_print(tic_mem* memory, const char* text, s32 x, s32 y, u8 color, bool fixed, s32 scale, bool alt)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_print);
+    u8 mapping[TIC_PALETTE_SIZE] = { 255, color };
+
+    const tic_font_data* font = alt ? &memory->ram->font.alt : &memory->ram->font.regular;
+    s32 width = font->width;
+
+    // Compatibility : print uses reduced width for non-fixed space
+    if (!fixed) width -= 2;
+    s32 result = submitText((tic_core*)memory, 1, text, x, y, width, font->height, fixed, mapping, scale, alt);
+
+    tic_core_stats_draw_end(memory, start);
+    return result;
+}
+
+void tic_api_spr(tic_mem* memory, s32 index, s32 x, s32 y, s32 w, s32 h, u8* trans_colors, u8 trans_count, s32 scale, tic_flip flip, tic_rotate rotate)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_spr);
+
+    SprArgs args = {index, x, y, w, h, scale, flip, rotate};
+    getPalette(memory, args.mapping, trans_colors, trans_count);
+    submitCommand((tic_core*)memory, DrawSpr, 0, &args, sizeof args);
+
+    tic_core_stats_draw_end(memory, start);
+}
+
+static inline u8* getFlag(tic_mem* memory, s32 index, u8 flag)
+{
+    static u8 stub = 0;
+    if (index >= TIC_FLAGS || flag >= BITS_IN_BYTE)
+        return &stub;
+
+    return memory->ram->flags.data + index;
+}
+
+bool tic_api_fget(tic_mem* memory, s32 index, u8 flag)
+{
+    tic_core_stats_call(memory, tic_api_id_fget);
+    return *getFlag(memory, index, flag) & (1 << flag);
+}
+
+void tic_api_fset(tic_mem* memory, s32 index, u8 flag, bool value)
+{
+    tic_core_stats_call(memory, tic_api_id_fset);
+
+    if (value)
+        *getFlag(memory, index, flag) |= (1 << flag);
+    else
+        *getFlag(memory, index, flag) &= ~(1 << flag);
+}
+
+u8 tic_api_pix(tic_mem* memory, s32 x, s32 y, u8 color, bool get)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_stats_draw(memory, tic_api_id_pix);
+
+    u8 result = 0;
+
+    if (get)
+    {
+        tic_core_draw_flush(memory);
+        result = getPixel(core, x, y);
+    }
+    else submitCommand(core, DrawPix, mapColor(memory, color), &(PixArgs){x, y}, sizeof(PixArgs));
+
+    tic_core_stats_draw_end(memory, start);
+    return result;
+}
+
+void tic_api_rectb(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, u8 color)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_stats_draw(memory, tic_api_id_rectb);
+
+    submitCommand(core, DrawRectb, mapColor(memory, color), &(RectArgs){x, y, width, height}, sizeof(RectArgs));
+
+    tic_core_stats_draw_end(memory, start);
+}
+
+void tic_api_circ(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_circ);
+    submitCommand((tic_core*)memory, DrawElli, mapColor(memory, color), &(ElliArgs){x, y, r, r}, sizeof(ElliArgs));
+    tic_core_stats_draw_end(memory, start);
+}
+
+void tic_api_circb(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_circb);
+    submitCommand((tic_core*)memory, DrawEllib, mapColor(memory, color), &(ElliArgs){x, y, r, r}, sizeof(ElliArgs));
+    tic_core_stats_draw_end(memory, start);
+}
+
+void tic_api_elli(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_elli);
+    submitCommand((tic_core*)memory, DrawElli, mapColor(memory, color), &(ElliArgs){x, y, a, b}, sizeof(ElliArgs));
+    tic_core_stats_draw_end(memory, start);
+}
+
+void tic_api_ellib(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
+{
+    u64 start = tic_core_stats_draw(memory, tic_api_id_ellib);
+    submitCommand((tic_core*)memory, DrawEllib, mapColor(memory, color), &(ElliArgs){x, y, a, b}, sizeof(ElliArgs));
+    tic_core_stats_draw_end(memory, start);
+}
+
+void tic_api_tri(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3, u8 color)
+{
+    u64 start = tic_core_stats_draw(tic, tic_api_id_tri);
+    submitCommand((tic_core*)tic, DrawTri, mapColor(tic, color), &(TriArgs){x1, y1, x2, y2, x3, y3}, sizeof(TriArgs));
+    tic_core_stats_draw_end(tic, start);
+}
+
+void tic_api_trib(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3, u8 color)
+{
+    u64 start = tic_core_stats_draw(tic, tic_api_id_trib);
+    submitCommand((tic_core*)tic, DrawTrib, mapColor(tic, color), &(TriArgs){x1, y1, x2, y2, x3, y3}, sizeof(TriArgs));
+    tic_core_stats_draw_end(tic, start);
+}
+
+void tic_api_ttri(tic_mem* tic,
+    float x1, float y1,
+    float x2, float y2,
+    float x3, float y3,
+    float u1, float v1,
+    float u2, float v2,
+    float u3, float v3,
+    tic_texture_src texsrc, u8* colors, s32 count,
+    float z1, float z2, float z3, bool depth)
+{
+    u64 start = tic_core_stats_draw(tic, tic_api_id_ttri);
+
+    // do not use depth if user passed z=0.0
+    if(z1 < FLT_EPSILON || z2 < FLT_EPSILON || z3 < FLT_EPSILON)
+        depth = false;
+
+    if(texsrc >= 0 && texsrc < COUNT_OF(TexShaders))
+    {
+        TtriArgs args =
+        {
+            .x = {x1, x2, x3},
+            .y = {y1, y2, y3},
+            .u = {u1, u2, u3},
+            .v = {v1, v2, v3},
+            .z = {z1, z2, z3},
+            .texsrc = texsrc,
+            .depth = depth,
+        };
+
+        getPalette(tic, args.mapping, colors, count);
+        submitCommand((tic_core*)tic, DrawTtri, 0, &args, sizeof args);
+    }
+
+    tic_core_stats_draw_end(tic, start);
 }
 
 void tic_api_map(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, s32 sx, s32 sy, u8* colors, u8 count, s32 scale, RemapFunc remap, void* data)
 {
-    drawMap((tic_core*)memory, &memory->ram->map, x, y, width, height, sx, sy, colors, count, scale, remap, data);
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_stats_draw(memory, tic_api_id_map);
+
+    MapArgs args = {x, y, width, height, sx, sy, scale};
+    getPalette(memory, args.mapping, colors, count);
+
+    if (remap)
+    {
+        // remap calls the script, the map is drawn right after the recorded
+        // calls and the calls made from remap are drawn immediately
+        bool recording = core->deferred.recording;
+
+        tic_core_draw_flush(memory);
+        core->deferred.recording = false;
+        drawMap(core, &core->state.clip, NULL, &args, remap, data);
+        core->deferred.recording = recording;
+    }
+    else submitCommand(core, DrawMap, 0, &args, sizeof args);
+
+    tic_core_stats_draw_end(memory, start);
 }
 
 void tic_api_mset(tic_mem* memory, s32 x, s32 y, u8 value)
 {
+    tic_core_stats_call(memory, tic_api_id_mset);
+
     if (x < 0 || x >= TIC_MAP_WIDTH || y < 0 || y >= TIC_MAP_HEIGHT) return;
 
+    // the recorded map calls read the old tiles
+    tic_core_draw_flush(memory);
+
     tic_map* src = &memory->ram->map;
     *(src->data + y * TIC_MAP_WIDTH + x) = value;
 }
 
 u8 tic_api_mget(tic_mem* memory, s32 x, s32 y)
 {
+    tic_core_stats_call(memory, tic_api_id_mget);
+
     if (x < 0 || x >= TIC_MAP_WIDTH || y < 0 || y >= TIC_MAP_HEIGHT) return 0;
 
     const tic_map* src = &memory->ram->map;
@@ -912,7 +1407,9 @@ u8 tic_api_mget(tic_mem* memory, s32 x, s32 y)
 
 void tic_api_line(tic_mem* memory, float x0, float y0, float x1, float y1, u8 color)
 {
-    drawLine(memory, x0, y0, x1, y1, mapColor(memory, color));
+    u64 start = tic_core_stats_draw(memory, tic_api_id_line);
+    submitCommand((tic_core*)memory, DrawLine, mapColor(memory, color), &(LineArgs){x0, y0, x1, y1}, sizeof(LineArgs));
+    tic_core_stats_draw_end(memory, start);
 }
 
 #if defined(BUILD_DEPRECATED)
@@ -108,7 +108,10 @@ void tic_core_textri_dep(tic_core* core, float x1, float y1, float x2, float y2,
     tic_mem* memory = &core->memory;
     tic_vram* vram = &memory->ram->vram;
 
-    u8* mapping = getPalette(memory, colors, count);
+    tic_core_draw_flush(memory);
+
+    u8 mapping[TIC_PALETTE_SIZE];
+    getPalette(memory, mapping, colors, count);
     TexVertDep V0, V1, V2;
 
     const u8* map = memory->ram->map.data;
@@ -134,7 +137,7 @@ void tic_core_textri_dep(tic_core* core, float x1, float y1, float x2, float y2,
     s32 dudxs = (s32)(dudx * 65536.0f);
     s32 dvdxs = (s32)(dvdx * 65536.0f);
     //  fill the buffer 
-    for (s32 i = 0; i < COUNT_OF(SidesBuffer.Left); i++)
+    for (s32 i = 0; i < COUNT_OF(SidesBufferDep.Left); i++)
         SidesBufferDep.Left[i] = TIC80_WIDTH, SidesBufferDep.Right[i] = -1;
 
     //  parse each line and decide where in the buffer to store them ( left or right ) 
@@ -183,7 +186,7 @@ void tic_core_textri_dep(tic_core* core, float x1, float y1, float x2, float y2,
 
                     u8 color = mapping[tic_tilesheet_gettilepix(&tile, iu & 7, iv & 7)];
                     if (color != TRANSPARENT_COLOR)
-                        setPixel(core, x, y, color);
+                        setPixel(core, &core->state.clip, x, y, color);
                     u += dudxs;
                     v += dvdxs;
                 }
@@ -199,7 +202,7 @@ void tic_core_textri_dep(tic_core* core, float x1, float y1, float x2, float y2,
 
                     u8 color = mapping[tic_tilesheet_getpix(&sheet, iu, iv)];
                     if (color != TRANSPARENT_COLOR)
-                        setPixel(core, x, y, color);
+                        setPixel(core, &core->state.clip, x, y, color);
                     u += dudxs;
                     v += dvdxs;
                 }
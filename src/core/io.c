@@ -43,6 +43,7 @@ static bool isKeyPressed(const tic80_keyboard* input, tic_key key)
 u32 tic_api_btnp(tic_mem* tic, s32 index, s32 hold, s32 period)
 {
     tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_btnp);
 
     if (index < 0)
     {
@@ -65,6 +66,7 @@ u32 tic_api_btnp(tic_mem* tic, s32 index, s32 hold, s32 period)
 u32 tic_api_btn(tic_mem* tic, s32 index)
 {
     tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_btn);
 
     if (index < 0)
     {
@@ -78,6 +80,8 @@ u32 tic_api_btn(tic_mem* tic, s32 index)
 
 bool tic_api_key(tic_mem* tic, tic_key key)
 {
+    tic_core_stats_call(tic, tic_api_id_key);
+
     return key > tic_key_unknown
         ? isKeyPressed(&tic->ram->input.keyboard, key)
         : tic->ram->input.keyboard.data;
@@ -86,6 +90,7 @@ bool tic_api_key(tic_mem* tic, tic_key key)
 bool tic_api_keyp(tic_mem* tic, tic_key key, s32 hold, s32 period)
 {
     tic_core* core = (tic_core*)tic;
+    tic_core_stats_call(tic, tic_api_id_keyp);
 
     if (key > tic_key_unknown)
     {
@@ -127,6 +132,8 @@ bool tic_api_keyp(tic_mem* tic, tic_key key, s32 hold, s32 period)
 
 tic_point tic_api_mouse(tic_mem* memory)
 {
+    tic_core_stats_call(memory, tic_api_id_mouse);
+
     return memory->ram->input.mouse.relative 
         ? (tic_point){memory->ram->input.mouse.rx, memory->ram->input.mouse.ry}
         : (tic_point){memory->ram->input.mouse.x - TIC80_OFFSET_LEFT, memory->ram->input.mouse.y - TIC80_OFFSET_TOP};
@@ -0,0 +1,194 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "core.h"
+
+#include <stdlib.h>
+
+#if defined(TIC_BUILD_WITH_JOBS)
+
+#include <pthread.h>
+
+struct tic_jobs
+{
+    pthread_t* threads;
+    s32 count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+
+    // the current batch, the bands are taken one by one
+    // by the workers and the calling thread
+    struct
+    {
+        tic_job_func func;
+        void* data;
+        s32 count;
+        s32 next;
+        s32 finished;
+        u32 id;
+    } batch;
+
+    bool quit;
+};
+
+// takes the bands until there are none left, called with the lock held
+static void runBands(tic_jobs* jobs)
+{
+    while(jobs->batch.next < jobs->batch.count)
+    {
+        s32 band = jobs->batch.next++;
+
+        pthread_mutex_unlock(&jobs->lock);
+        jobs->batch.func(jobs->batch.data, band, jobs->batch.count);
+        pthread_mutex_lock(&jobs->lock);
+
+        if(++jobs->batch.finished == jobs->batch.count)
+            pthread_cond_signal(&jobs->done);
+    }
+}
+
+static void* worker(void* data)
+{
+    tic_jobs* jobs = data;
+    u32 id = 0;
+
+    pthread_mutex_lock(&jobs->lock);
+
+    while(true)
+    {
+        while(!jobs->quit && jobs->batch.id == id)
+            pthread_cond_wait(&jobs->start, &jobs->lock);
+
+        if(jobs->quit)
+            break;
+
+        id = jobs->batch.id;
+        runBands(jobs);
+    }
+
+    pthread_mutex_unlock(&jobs->lock);
+
+    return NULL;
+}
+
+tic_jobs* tic_jobs_create(s32 threads)
+{
+    if(threads <= 0)
+        return NULL;
+
+    tic_jobs* jobs = calloc(1, sizeof(tic_jobs));
+    jobs->threads = calloc(threads, sizeof(pthread_t));
+
+    pthread_mutex_init(&jobs->lock, NULL);
+    pthread_cond_init(&jobs->start, NULL);
+    pthread_cond_init(&jobs->done, NULL);
+
+    for(s32 i = 0; i < threads; i++)
+        if(pthread_create(&jobs->threads[jobs->count], NULL, worker, jobs) == 0)
+            jobs->count++;
+
+    if(!jobs->count)
+    {
+        tic_jobs_delete(jobs);
+        return NULL;
+    }
+
+    return jobs;
+}
+
+void tic_jobs_delete(tic_jobs* jobs)
+{
+    if(!jobs) return;
+
+    pthread_mutex_lock(&jobs->lock);
+    jobs->quit = true;
+    pthread_cond_broadcast(&jobs->start);
+    pthread_mutex_unlock(&jobs->lock);
+
+    for(s32 i = 0; i < jobs->count; i++)
+        pthread_join(jobs->threads[i], NULL);
+
+    pthread_cond_destroy(&jobs->done);
+    pthread_cond_destroy(&jobs->start);
+    pthread_mutex_destroy(&jobs->lock);
+
+    free(jobs->threads);
+    free(jobs);
+}
+
+s32 tic_jobs_threads(const tic_jobs* jobs)
+{
+    return jobs ? jobs->count + 1 : 1;
+}
+
+void tic_jobs_run(tic_jobs* jobs, tic_job_func func, void* data, s32 count)
+{
+    if(!jobs || count < 2)
+    {
+        for(s32 i = 0; i < count; i++)
+            func(data, i, count);
+
+        return;
+    }
+
+    pthread_mutex_lock(&jobs->lock);
+
+    jobs->batch.func = func;
+    jobs->batch.data = data;
+    jobs->batch.count = count;
+    jobs->batch.next = 0;
+    jobs->batch.finished = 0;
+    jobs->batch.id++;
+
+    pthread_cond_broadcast(&jobs->start);
+
+    runBands(jobs);
+
+    while(jobs->batch.finished < jobs->batch.count)
+        pthread_cond_wait(&jobs->done, &jobs->lock);
+
+    pthread_mutex_unlock(&jobs->lock);
+}
+
+#else
+
+tic_jobs* tic_jobs_create(s32 threads)
+{
+    return NULL;
+}
+
+void tic_jobs_delete(tic_jobs* jobs) {}
+
+s32 tic_jobs_threads(const tic_jobs* jobs)
+{
+    return 1;
+}
+
+void tic_jobs_run(tic_jobs* jobs, tic_job_func func, void* data, s32 count)
+{
+    for(s32 i = 0; i < count; i++)
+        func(data, i, count);
+}
+
+#endif
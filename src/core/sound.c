@@ -489,6 +489,7 @@ static void setMusic(tic_core* core, s32 index, s32 frame, s32 row, bool loop, b
 void tic_api_music(tic_mem* memory, s32 index, s32 frame, s32 row, bool loop, bool sustain, s32 tempo, s32 speed)
 {
     tic_core* core = (tic_core*)memory;
+    tic_core_stats_call(memory, tic_api_id_music);
 
     setMusic(core, index, frame, row, loop, sustain, tempo, speed);
 
@@ -499,6 +500,7 @@ void tic_api_music(tic_mem* memory, s32 index, s32 frame, s32 row, bool loop, bo
 void tic_api_sfx(tic_mem* memory, s32 index, s32 note, s32 octave, s32 duration, s32 channel, s32 left, s32 right, s32 speed)
 {
     tic_core* core = (tic_core*)memory;
+    tic_core_stats_call(memory, tic_api_id_sfx);
     setSfxChannelData(memory, index, note, octave, duration, channel, left, right, speed);
 }
 
@@ -526,6 +528,7 @@ static void stereo_synthesize(tic_core* core, tic_sound_register_data* registers
 void tic_core_synth_sound(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_stats_counter(core);
 
     // synthesize sound using the register values found from the tail of the ring buffer
     stereo_synthesize(core, core->state.registers.left, core->blip.left, 0);
@@ -541,6 +544,9 @@ void tic_core_synth_sound(tic_mem* memory)
         // assuming it is aligned in memory (which it should be)
         core->state.sound_ringbuf_tail = (core->state.sound_ringbuf_tail + 1) % TIC_SOUND_RINGBUF_LEN;
     }
+
+    if(start)
+        core->stats.time.sound += tic_core_stats_counter(core) - start;
 }
 
 void tic_core_sound_tick_start(tic_mem* memory)
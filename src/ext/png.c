@@ -222,6 +222,51 @@ static inline s32 ceildiv(s32 a, s32 b)
     return (a + b - 1) / b;
 }
 
+static inline u32 readBE32(const u8* ptr)
+{
+    return ((u32)ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
+}
+
+// looks for the cart chunk without decoding the image
+static png_buffer findCart(png_buffer buf)
+{
+    enum{ChunkHeader = 8, ChunkCrc = 4};
+
+    if(buf.size < 8 || png_sig_cmp(buf.data, 0, 8) != 0)
+        return (png_buffer){0};
+
+    const u8* ptr = buf.data + 8;
+    const u8* end = buf.data + buf.size;
+
+    while(end - ptr >= ChunkHeader + ChunkCrc)
+    {
+        u32 size = readBE32(ptr);
+
+        if(size > end - ptr - ChunkHeader - ChunkCrc)
+            break;
+
+        const u8* type = ptr + 4;
+        const u8* data = ptr + ChunkHeader;
+
+        if(memcmp(type, EXTRA_CHUNK, 4) == 0 && size > 0)
+        {
+            png_buffer cart = {malloc(size), size};
+
+            if(cart.data)
+                memcpy(cart.data, data, size);
+
+            return cart.data ? cart : (png_buffer){0};
+        }
+
+        if(memcmp(type, "IEND", 4) == 0)
+            break;
+
+        ptr = data + size + ChunkCrc;
+    }
+
+    return (png_buffer){0};
+}
+
 png_buffer png_encode(png_buffer cover, png_buffer cart)
 {    
     png_img png = png_read(cover, NULL);
@@ -236,13 +281,41 @@ png_buffer png_encode(png_buffer cover, png_buffer cart)
         for (s32 i = 0; i < HEADER_SIZE; i++)
             bitcpy(png.data, i << 3, header.data, i * HEADER_BITS, HEADER_BITS);
 
+        // the low bits of every byte are replaced with the next bits of the cart
         u8* dst = png.data + HEADER_SIZE;
-        s32 end = ceildiv(cartBits, header.bits);
+        const u8* src = cart.data;
+        const u8* srcEnd = cart.data + cart.size;
+        const u32 bits = header.bits;
+        const u8 mask = (1 << bits) - 1;
+        s32 end = ceildiv(cartBits, bits);
+
+        u32 acc = 0;
+        u32 count = 0;
+
         for (s32 i = 0; i < end; i++)
-            bitcpy(dst, i << 3, cart.data, i * header.bits, header.bits);
+        {
+            if (count < bits)
+            {
+                acc |= (src < srcEnd ? *src++ : 0) << count;
+                count += BITS_IN_BYTE;
+            }
+
+            dst[i] = (dst[i] & ~mask) | (acc & mask);
+            acc >>= bits;
+            count -= bits;
+        }
+
+        // the rest of the cover gets the noise
+        u32 seed = rand() | 1;
 
         for (s32 i = end; i < coverSize; i++)
-            bitcpy(dst, i << 3, (const u8[]){rand()}, 0, header.bits);
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+
+            dst[i] = (dst[i] & ~mask) | (seed & mask);
+        }
     }
 
     png_buffer out = png_write(png, cart);
@@ -254,18 +327,15 @@ png_buffer png_encode(png_buffer cover, png_buffer cart)
 
 png_buffer png_decode(png_buffer cover)
 {
-    png_buffer cart = { 0 };
-    png_img png = png_read(cover, &cart);
+    // the cart chunk doesn't need the image
+    png_buffer cart = findCart(cover);
 
-    // if we have a data from a png chunk, use that
-    if (cart.data && cart.size > 0)
-    {
-        if (png.data)
-            free(png.data);
+    if (cart.data)
         return cart;
-    }
 
     // otherwise fallback to steganography
+    png_img png = png_read(cover, NULL);
+
     if (png.data)
     {
         Header header;
@@ -278,17 +348,35 @@ png_buffer png_decode(png_buffer cover)
             && header.size > 0 
             && header.size <= png.width * png.height * RGBA_SIZE * header.bits / BITS_IN_BYTE - HEADER_SIZE)
         {
-            s32 aligned = header.size + ceildiv(header.size * BITS_IN_BYTE % header.bits, BITS_IN_BYTE);
-            png_buffer out = { malloc(aligned), header.size };
+            png_buffer out = { malloc(header.size), header.size };
 
+            // collects the low bits of every byte back to the cart bytes
             const u8* from = png.data + HEADER_SIZE;
-            for (s32 i = 0, end = ceildiv(header.size * BITS_IN_BYTE, header.bits); i < end; i++)
-                bitcpy(out.data, i * header.bits, from, i << 3, header.bits);
+            const u32 bits = header.bits;
+            const u8 mask = (1 << bits) - 1;
+
+            u32 acc = 0;
+            u32 count = 0;
+
+            for (u8 *dst = out.data, *end = out.data + out.size; dst < end; from++)
+            {
+                acc |= (*from & mask) << count;
+                count += bits;
+
+                if (count >= BITS_IN_BYTE)
+                {
+                    *dst++ = acc;
+                    acc >>= BITS_IN_BYTE;
+                    count -= BITS_IN_BYTE;
+                }
+            }
 
             free(png.data);
 
             return out;
         }
+
+        free(png.data);
     }
 
     return (png_buffer) { 0 };
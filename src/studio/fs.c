@@ -59,6 +59,12 @@
 #include <emscripten.h>
 #endif
 
+#if (defined(__TIC_LINUX__) || defined(__TIC_MACOSX__)) && !defined(BAREMETALPI) && !defined(__EMSCRIPTEN__)
+#define FS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 static const char* PublicDir = TIC_HOST;
 
 struct tic_fs
@@ -165,6 +171,7 @@ static const char* stringToUtf8(const FsString* wstr)
 #define tic_rmdir _wrmdir
 #define tic_stat _wstat
 #define tic_remove _wremove
+#define tic_rename(from, to) (MoveFileExW(from, to, MOVEFILE_REPLACE_EXISTING) != 0)
 #define tic_fopen _wfopen
 #define tic_mkdir(name) _wmkdir(name)
 #define tic_strncpy wcsncpy
@@ -191,6 +198,7 @@ typedef char FsString;
 #define tic_rmdir rmdir
 #define tic_stat stat
 #define tic_remove remove
+#define tic_rename(from, to) (rename(from, to) == 0)
 #define tic_fopen fopen
 #define tic_mkdir(name) mkdir(name, 0777)
 #define tic_strncpy strncpy
@@ -647,6 +655,82 @@ bool fs_write(const char* name, const void* buffer, s32 size)
 #endif
 }
 
+#if defined(BAREMETALPI)
+static bool writeFilePart(void* file, const void* data, s32 size)
+{
+    u32 written = 0;
+    return f_write(file, data, size, &written) == FR_OK && written == size;
+}
+#else
+static bool writeFilePart(void* file, const void* data, s32 size)
+{
+    return fwrite(data, 1, size, file) == size;
+}
+#endif
+
+// the parts callback writes the file piece by piece, so the whole
+// content doesn't have to be in memory, the parts go to a temporary
+// file that replaces the target only when all of them are written
+bool fs_write_parts(const char* name, fs_parts_callback parts, void* data)
+{
+    char temp[TICNAME_MAX];
+
+    if(snprintf(temp, sizeof temp, "%s.tmp", name) >= sizeof temp)
+        return false;
+
+#if defined(BAREMETALPI)
+    dbg("fs_write_parts %s\n", name);
+    FIL file;
+
+    if(f_open(&file, temp, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
+        return false;
+
+    bool done = parts(writeFilePart, &file, data);
+    done = f_close(&file) == FR_OK && done;
+
+    if(done)
+    {
+        f_unlink(name);
+        done = f_rename(temp, name) == FR_OK;
+    }
+
+    if(!done)
+        f_unlink(temp);
+
+    return done;
+#else
+    const FsString* tempString = utf8ToString(temp);
+    FILE* file = tic_fopen(tempString, _S("wb"));
+
+    bool done = false;
+
+    if(file)
+    {
+        done = parts(writeFilePart, file, data);
+        done = fclose(file) == 0 && done;
+
+        if(done)
+        {
+            const FsString* pathString = utf8ToString(name);
+            done = tic_rename(tempString, pathString);
+            freeString(pathString);
+        }
+
+        if(!done)
+            tic_remove(tempString);
+    }
+
+    freeString(tempString);
+
+#if defined(__EMSCRIPTEN__)
+    if(done)
+        syncfs();
+#endif
+
+    return done;
+#endif
+}
+
 void* fs_read(const char* path, s32* size)
 {
 #if defined(BAREMETALPI)
@@ -691,6 +775,64 @@ void* fs_read(const char* path, s32* size)
 #endif
 }
 
+// maps the file read-only where possible, the data is parsed straight
+// from the page cache instead of being copied to the heap first,
+// reading a page of a file truncated by another program raises SIGBUS,
+// so it's only for the executable and the one-shot loads, the files
+// that can be edited outside (the project reload) go through fs_read
+const void* fs_map(const char* path, s32* size)
+{
+#if defined(FS_MMAP)
+    s32 fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+        return NULL;
+
+    struct stat s;
+    void* data = NULL;
+
+    if(fstat(fd, &s) == 0 && S_ISREG(s.st_mode) && s.st_size > 0 && s.st_size <= INT32_MAX)
+    {
+        data = mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // the file system can't map it, read it to anonymous pages instead,
+        // so fs_unmap always releases the same way
+        if(data == MAP_FAILED)
+        {
+            data = mmap(NULL, s.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if(data != MAP_FAILED && pread(fd, data, s.st_size, 0) != s.st_size)
+            {
+                munmap(data, s.st_size);
+                data = MAP_FAILED;
+            }
+        }
+
+        if(data == MAP_FAILED)
+            data = NULL;
+        else
+            *size = (s32)s.st_size;
+    }
+
+    close(fd);
+
+    return data;
+#else
+    return fs_read(path, size);
+#endif
+}
+
+void fs_unmap(const void* data, s32 size)
+{
+    if(!data) return;
+
+#if defined(FS_MMAP)
+    munmap((void*)data, size);
+#else
+    free((void*)data);
+#endif
+}
+
 bool fs_exists(const char* name)
 {
 #if defined(BAREMETALPI)
@@ -737,6 +879,28 @@ u64 fs_date(const char* path)
 #endif
 }
 
+s32 fs_size(const char* path)
+{
+#if defined(BAREMETALPI)
+    dbg("fs_size %s\n", path);
+    // TODO BAREMETALPI
+    return 0;
+#else
+    struct tic_stat_struct s;
+
+    const FsString* pathString = utf8ToString(path);
+    s32 ret = tic_stat(pathString, &s);
+    freeString(pathString);
+
+    if(ret == 0 && S_ISREG(s.st_mode))
+    {
+        return (s32)s.st_size;
+    }
+
+    return 0;
+#endif
+}
+
 bool tic_fs_save(tic_fs* fs, const char* name, const void* data, s32 size, bool overwrite)
 {
     if(!overwrite)
@@ -748,6 +912,17 @@ bool tic_fs_save(tic_fs* fs, const char* name, const void* data, s32 size, bool
     return fs_write(tic_fs_path(fs, name), data, size);
 }
 
+bool tic_fs_save_parts(tic_fs* fs, const char* name, fs_parts_callback parts, void* data, bool overwrite)
+{
+    if(!overwrite)
+    {
+        if(tic_fs_exists(fs, name))
+            return false;
+    }
+
+    return fs_write_parts(tic_fs_path(fs, name), parts, data);
+}
+
 bool tic_fs_saveroot(tic_fs* fs, const char* name, const void* data, s32 size, bool overwrite)
 {
     const char* path = tic_fs_pathroot(fs, name);
@@ -29,6 +29,8 @@ typedef bool(*fs_list_callback)(const char* name, const char* title, const char*
 typedef void(*fs_done_callback)(void* data);
 typedef void(*fs_isdir_callback)(bool dir, void* data);
 typedef void(*fs_load_callback)(const u8* buffer, s32 size, void* data);
+typedef bool(*fs_write_func)(void* file, const void* data, s32 size);
+typedef bool(*fs_parts_callback)(fs_write_func write, void* file, void* data);
 
 typedef struct tic_fs tic_fs;
 struct tic_net;
@@ -44,6 +46,7 @@ bool    tic_fs_delfile      (tic_fs* fs, const char* name);
 bool    tic_fs_deldir       (tic_fs* fs, const char* name);
 bool    tic_fs_save         (tic_fs* fs, const char* name, const void* data, s32 size, bool overwrite);
 bool    tic_fs_saveroot     (tic_fs* fs, const char* name, const void* data, s32 size, bool overwrite);
+bool    tic_fs_save_parts   (tic_fs* fs, const char* name, fs_parts_callback parts, void* data, bool overwrite);
 void*   tic_fs_load         (tic_fs* fs, const char* name, s32* size);
 void*   tic_fs_loadroot     (tic_fs* fs, const char* name, s32* size);
 bool    tic_fs_makedir      (tic_fs* fs, const char* name);
@@ -57,6 +60,10 @@ void    tic_fs_dirback      (tic_fs* fs);
 void    tic_fs_homedir      (tic_fs* fs);
 
 u64     fs_date     (const char* name);
+s32     fs_size     (const char* name);
 bool    fs_exists   (const char* name);
 void*   fs_read     (const char* path, s32* size);
+const void* fs_map  (const char* path, s32* size);
+void    fs_unmap    (const void* data, s32 size);
 bool    fs_write    (const char* path, const void* data, s32 size);
+bool    fs_write_parts(const char* path, fs_parts_callback parts, void* data);
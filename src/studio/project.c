@@ -51,69 +51,106 @@ static void makeTag(const char* tag, char* out, s32 bank)
     else strcpy(out, tag);
 }
 
-static void buf2str(const void* data, s32 size, char* ptr, bool flip)
+static bool bufferEmpty(const u8* data, s32 size)
+{
+    // the buffer is empty when the first byte is zero and every byte equals the next one
+    return data[0] == 0 && memcmp(data, data + 1, size - 1) == 0;
+}
+
+// the project text is written by parts through the sink
+typedef struct
+{
+    tic_project_sink sink;
+    void* data;
+    s32 size;
+    bool failed;
+
+    s32 used;
+    char buffer[16 * 1024];
+} Writer;
+
+static void writerFlush(Writer* writer)
 {
-    enum {Len = 2};
+    if(writer->used && !writer->failed)
+        writer->failed = !writer->sink(writer->data, writer->buffer, writer->used);
+
+    writer->size += writer->used;
+    writer->used = 0;
+}
 
-    for(s32 i = 0; i < size; i++, ptr+=Len)
+static void writeData(Writer* writer, const void* data, s32 size)
+{
+    while(size > 0)
     {
-        sprintf(ptr, "%02x", ((u8*)data)[i]);
-        if(flip) SWAP(ptr[0], ptr[1], char);
+        s32 part = MIN(size, (s32)sizeof writer->buffer - writer->used);
+
+        memcpy(writer->buffer + writer->used, data, part);
+        writer->used += part;
+        data = (const u8*)data + part;
+        size -= part;
+
+        if(writer->used == sizeof writer->buffer)
+            writerFlush(writer);
     }
 }
 
-static bool bufferEmpty(const u8* data, s32 size)
+static void writeString(Writer* writer, const char* str)
 {
-    for(s32 i = 0; i < size; i++)
-        if(*data++)
-            return false;
-
-    return true;
+    writeData(writer, str, (s32)strlen(str));
 }
 
-static char* saveTextSection(char* ptr, const char* data)
+static void writeHex(Writer* writer, const u8* data, s32 size, bool flip)
 {
-    if(data[0] == '\0')
-        return ptr;
+    static const char Digits[] = "0123456789abcdef";
 
-    sprintf(ptr, "%s\n", data);
-    ptr += strlen(ptr);
+    for(const u8* end = data + size; data != end; data++)
+    {
+        if(writer->used + 2 > sizeof writer->buffer)
+            writerFlush(writer);
 
-    return ptr;
+        char* ptr = writer->buffer + writer->used;
+        ptr[flip] = Digits[*data >> 4];
+        ptr[!flip] = Digits[*data & 0xf];
+        writer->used += 2;
+    }
 }
 
-static char* saveBinaryBuffer(char* ptr, const char* comment, const void* data, s32 size, s32 row, bool flip)
+static void saveTextSection(Writer* writer, const char* data)
 {
-    if(bufferEmpty(data, size)) 
-        return ptr;
+    if(data[0] == '\0')
+        return;
 
-    sprintf(ptr, "%s %03i:", comment, row);
-    ptr += strlen(ptr);
+    writeString(writer, data);
+    writeString(writer, "\n");
+}
 
-    buf2str(data, size, ptr, flip);
-    ptr += strlen(ptr);
+static void saveBinaryBuffer(Writer* writer, const char* comment, const void* data, s32 size, s32 row, bool flip)
+{
+    if(bufferEmpty(data, size)) 
+        return;
 
-    sprintf(ptr, "\n");
-    ptr += strlen(ptr);
+    char header[32];
+    snprintf(header, sizeof header, "%s %03i:", comment, row);
+    writeString(writer, header);
 
-    return ptr;
+    writeHex(writer, data, size, flip);
+    writeString(writer, "\n");
 }
 
-static char* saveBinarySection(char* ptr, const char* comment, const char* tag, s32 count, const void* data, s32 size, bool flip)
+static void saveBinarySection(Writer* writer, const char* comment, const char* tag, s32 count, const void* data, s32 size, bool flip)
 {
     if(bufferEmpty(data, size * count)) 
-        return ptr;
+        return;
 
-    sprintf(ptr, "%s <%s>\n", comment, tag);
-    ptr += strlen(ptr);
+    char line[64];
+    snprintf(line, sizeof line, "%s <%s>\n", comment, tag);
+    writeString(writer, line);
 
     for(s32 i = 0; i < count; i++, data = (u8*)data + size)
-        ptr = saveBinaryBuffer(ptr, comment, data, size, i, flip);
-
-    sprintf(ptr, "%s </%s>\n\n", comment, tag);
-    ptr += strlen(ptr);
+        saveBinaryBuffer(writer, comment, data, size, i, flip);
 
-    return ptr;
+    snprintf(line, sizeof line, "%s </%s>\n\n", comment, tag);
+    writeString(writer, line);
 }
 
 static const char* projectComment(const char* name)
@@ -127,26 +164,68 @@ static const char* projectComment(const char* name)
     return Languages[0]->projectComment;
 }
 
-s32 tic_project_save(const char* name, void* data, const tic_cartridge* cart)
+s32 tic_project_write(const char* name, const tic_cartridge* cart, tic_project_sink sink, void* data)
 {
+    Writer* writer = malloc(sizeof(Writer));
+
+    if(!writer)
+        return -1;
+
+    *writer = (Writer){.sink = sink, .data = data};
+
     const char* comment = projectComment(name);
-    char* stream = data;
-    char* ptr = saveTextSection(stream, cart->code.data);
     char tag[16];
 
+    saveTextSection(writer, cart->code.data);
+
+    // the empty banks are checked once instead of section by section
+    bool empty[TIC_BANKS];
+    for(s32 b = 0; b < TIC_BANKS; b++)
+        empty[b] = bufferEmpty((const u8*)&cart->banks[b], sizeof(tic_bank));
+
     FOR(const struct BinarySection*, section, BinarySections)
         for(s32 b = 0; b < TIC_BANKS; b++)
         {
+            if(empty[b])
+                continue;
+
             makeTag(section->tag, tag, b);
 
-            ptr = saveBinarySection(ptr, comment, tag, section->count, 
+            saveBinarySection(writer, comment, tag, section->count, 
                 (u8*)&cart->banks[b] + section->offset, section->size, section->flip);
         }
 
     if(cart->lang)
-        ptr = saveBinarySection(ptr, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
+        saveBinarySection(writer, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
+
+    writerFlush(writer);
+
+    s32 size = writer->failed ? -1 : writer->size;
+    free(writer);
+
+    return size;
+}
+
+static bool writeMemory(void* data, const void* buffer, s32 size)
+{
+    char** ptr = data;
+
+    memcpy(*ptr, buffer, size);
+    *ptr += size;
+
+    return true;
+}
+
+s32 tic_project_save(const char* name, void* data, const tic_cartridge* cart)
+{
+    char* ptr = data;
+    s32 size = tic_project_write(name, cart, writeMemory, &ptr);
+
+    if(size < 0)
+        return 0;
 
-    return (s32)strlen(stream);
+    *ptr = '\0';
+    return size;
 }
 
 static bool loadTextSection(const char* project, const char* comment, char* dst, s32 size)
@@ -175,64 +254,134 @@ static bool loadTextSection(const char* project, const char* comment, char* dst,
     return done;
 }
 
-static inline const char* getLineEnd(const char* ptr)
+static inline const char* nextLine(const char* ptr)
 {
-    while(*ptr && isspace(*ptr) && *ptr++ != '\n');
+    while(*ptr && *ptr++ != '\n');
 
     return ptr;
 }
 
-static bool loadBinarySection(const char* project, const char* comment, const char* tag, s32 count, void* dst, s32 size, bool flip)
+// the tag of the '<comment> <TAG>' or '<comment> </TAG>' line, NULL if it's another line
+static const char* parseTag(const char* line, const char* comment, s32 commentLen, bool close, s32* len)
 {
-    char tagbuf[64];
-    sprintf(tagbuf, "%s <%s>", comment, tag);
+    if(strncmp(line, comment, commentLen) || line[commentLen] != ' ' || line[commentLen + 1] != '<')
+        return NULL;
 
-    const char* start = strstr(project, tagbuf);
-    bool done = false;
+    const char* tag = line + commentLen + 2;
 
-    if(start)
+    if(close)
     {
-        start += strlen(tagbuf);
-        start = getLineEnd(start);
+        if(*tag != '/') return NULL;
+        tag++;
+    }
+
+    const char* ptr = tag;
+    while(*ptr && *ptr != '>' && *ptr != '\n') ptr++;
+
+    if(*ptr != '>')
+        return NULL;
+
+    *len = (s32)(ptr - tag);
+    return tag;
+}
 
-        sprintf(tagbuf, "\n%s </%s>", comment, tag);
-        const char* end = strstr(start, tagbuf);
+static bool sameTag(const char* tag, s32 len, const char* name)
+{
+    return (s32)strlen(name) == len && memcmp(tag, name, len) == 0;
+}
+
+// finds the section and the bank named by the tag, e.g. MAP or MAP3
+static const struct BinarySection* findBinarySection(const char* tag, s32 len, s32* bank)
+{
+    char name[16];
 
-        if(end > start)
+    FOR(const struct BinarySection*, section, BinarySections)
+        for(s32 b = 0; b < TIC_BANKS; b++)
         {
-            const char* ptr = start;
+            makeTag(section->tag, name, b);
 
-            if(size > 0)
+            if(sameTag(tag, len, name))
             {
-                while(ptr < end)
-                {
-                    static char lineStr[] = "999";
-                    memcpy(lineStr, ptr + strlen(comment) + 1, sizeof lineStr - 1);
-
-                    s32 index = atoi(lineStr);
-                    
-                    if(index < count)
-                    {
-                        ptr += strlen(comment) + sizeof(" 999:") - 1;
-                        tic_tool_str2buf(ptr, size*2, (u8*)dst + size*index, flip);
-                        ptr += size*2 + 1;
-
-                        ptr = getLineEnd(ptr);
-                    }
-                    else break;
-                }               
+                *bank = b;
+                return section;
             }
-            else
-            {
-                ptr += strlen(comment) + sizeof(" 999:") - 1;
-                tic_tool_str2buf(ptr, (s32)(end - ptr), (u8*)dst, flip);
-            }
-
-            done = true;
         }
+
+    *bank = 0;
+    return sameTag(tag, len, LangSection.tag) ? &LangSection : NULL;
+}
+
+// loads the '<comment> NNN:hex' rows up to the closing tag, returns the line after it
+static const char* loadBinaryRows(const char* ptr, const char* comment, s32 commentLen, 
+    const char* tag, s32 len, const struct BinarySection* section, void* dst)
+{
+    // the section without the closing tag is skipped
+    const char* end = ptr;
+
+    for(s32 closeLen; *end; end = nextLine(end))
+    {
+        const char* closeTag = parseTag(end, comment, commentLen, true, &closeLen);
+
+        if(closeTag && closeLen == len && memcmp(closeTag, tag, len) == 0)
+            break;
     }
 
-    return done;
+    if(!*end)
+        return NULL;
+
+    for(; ptr < end; ptr = nextLine(ptr))
+    {
+        char lineStr[] = "999";
+        memcpy(lineStr, ptr + commentLen + 1, sizeof lineStr - 1);
+
+        s32 index = atoi(lineStr);
+
+        if(index >= section->count)
+            break;
+
+        tic_tool_str2buf(ptr + commentLen + sizeof(" 999:") - 1, section->size * 2, 
+            (u8*)dst + section->size * index, section->flip);
+    }
+
+    return nextLine(end);
+}
+
+// scans the project once and loads every section by its tag
+static void loadBinarySections(const char* project, const char* comment, tic_cartridge* cart)
+{
+    s32 commentLen = (s32)strlen(comment);
+
+    // the first section with the tag is loaded like it always was
+    u8 loaded[COUNT_OF(BinarySections) + 1] = {0};
+
+    for(const char* ptr = project; *ptr;)
+    {
+        s32 len, bank;
+        const char* tag = parseTag(ptr, comment, commentLen, false, &len);
+        const struct BinarySection* section = tag ? findBinarySection(tag, len, &bank) : NULL;
+
+        ptr = nextLine(ptr);
+
+        if(!section)
+            continue;
+
+        s32 index = section == &LangSection ? COUNT_OF(BinarySections) : (s32)(section - BinarySections);
+
+        if(loaded[index] & (1 << bank))
+            continue;
+
+        void* dst = section == &LangSection 
+            ? (void*)&cart->lang 
+            : (u8*)&cart->banks[bank] + section->offset;
+
+        const char* next = loadBinaryRows(ptr, comment, commentLen, tag, len, section, dst);
+
+        if(next)
+        {
+            loaded[index] |= 1 << bank;
+            ptr = next;
+        }
+    }
 }
 
 bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridge* dst)
@@ -257,22 +406,12 @@ bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridg
         if(cart)
         {
             const char* comment = projectComment(name);
-            char tag[16];
 
             if(loadTextSection(project, comment, cart->code.data, sizeof(tic_code)))
                 done = true;
 
             if(done)
-            {
-                FOR(const struct BinarySection*, section, BinarySections)
-                    for(s32 b = 0; b < TIC_BANKS; b++)
-                    {
-                        makeTag(section->tag, tag, b);
-                        loadBinarySection(project, comment, tag, section->count, (u8*)&cart->banks[b] + section->offset, section->size, section->flip);
-                    }
-
-                loadBinarySection(project, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
-            }
+                loadBinarySections(project, comment, cart);
 
             if(done)
                 memcpy(dst, cart, sizeof(tic_cartridge));
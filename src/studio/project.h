@@ -24,5 +24,12 @@
 
 #include "cart.h"
 
+// receives the project text by parts, returns false on failure
+typedef bool(*tic_project_sink)(void* data, const void* buffer, s32 size);
+
 bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridge* dst);
 s32 tic_project_save(const char* name, void* data, const tic_cartridge* cart);
+
+// writes the project through the sink without keeping the whole text in memory,
+// returns the written size or -1 if the sink failed
+s32 tic_project_write(const char* name, const tic_cartridge* cart, tic_project_sink sink, void* data);
@@ -128,6 +128,7 @@
     macro(bank)                 \
     macro(vbank)                \
     macro(id)                   \
+    macro(dict)                 \
     ALONE_KEY(macro)
 
 static const char* WelcomeText =
@@ -1956,7 +1957,9 @@ static void exportSprites(Console* console, const char* filename, tic_tile* base
     }
 }
 
-static void* embedCart(Console* console, u8* app, s32* size)
+// dict=1 zips the cart with the preset dictionary, it's smaller
+// but the players built before the dictionary can't unzip it
+static void* embedCart(Console* console, u8* app, s32* size, bool dict)
 {
     tic_mem* tic = console->tic;
     u8* data = NULL;
@@ -1971,7 +1974,7 @@ static void* embedCart(Console* console, u8* app, s32* size)
 
         SCOPE(free(zipData))
         {
-            if((zipSize = tic_tool_zip(zipData, zipSize, cart, cartSize)))
+            if((zipSize = (dict ? tic_tool_zip_cart : tic_tool_zip)(zipData, zipSize, cart, cartSize)))
             {
                 s32 appSize = *size;
 
@@ -2005,6 +2008,7 @@ typedef struct
 {
     Console* console;
     char filename[TICNAME_MAX];
+    bool dict;
 } GameExportData;
 
 static void onExportGet(const net_get_data* data)
@@ -2049,6 +2053,7 @@ static void onNativeExportGet(const net_get_data* data)
 
             char filename[TICNAME_MAX];
             strcpy(filename, exportData->filename);
+            bool dict = exportData->dict;
             free(exportData);
 
             s32 size = data->done.size;
@@ -2058,7 +2063,7 @@ static void onNativeExportGet(const net_get_data* data)
             const char* path = tic_fs_path(console->fs, filename);
             void* buf = NULL;
 
-            onFileExported(console, filename, (buf = embedCart(console, data->done.data, &size)) && fs_write(path, buf, size));
+            onFileExported(console, filename, (buf = embedCart(console, data->done.data, &size, dict)) && fs_write(path, buf, size));
             chmod(path, DEFAULT_CHMOD);
 
             if (buf)
@@ -2074,7 +2079,7 @@ static void exportGame(Console* console, const char* name, const char* system, n
 {
     tic_mem* tic = console->tic;
     printLine(console);
-    GameExportData data = {console};
+    GameExportData data = {console, .dict = params.dict};
     strcpy(data.filename, name);
 
     char url[TICNAME_MAX] = "/export/" DEF2STR(TIC_VERSION_MAJOR) "." DEF2STR(TIC_VERSION_MINOR) TIC_VERSION_STATUS "/";
@@ -2367,6 +2372,20 @@ static void drawShadowText(tic_mem* tic, const char* text, s32 x, s32 y, tic_col
 
 const char* readMetatag(const char* code, const char* tag, const char* comment);
 
+#if defined(TIC80_PRO)
+typedef struct
+{
+    const char* name;
+    const tic_cartridge* cart;
+} ProjectSave;
+
+static bool saveProjectParts(fs_write_func write, void* file, void* data)
+{
+    const ProjectSave* project = data;
+    return tic_project_write(project->name, project->cart, write, file) >= 0;
+}
+#endif
+
 static CartSaveResult saveCartName(Console* console, const char* name)
 {
     tic_mem* tic = console->tic;
@@ -2375,121 +2394,122 @@ static CartSaveResult saveCartName(Console* console, const char* name)
 
     if(name && strlen(name))
     {
-        u8* buffer = (u8*)malloc(sizeof(tic_cartridge) * 3);
-
-        if(buffer)
+        if(strcmp(name, CONFIG_TIC_PATH) == 0)
         {
-            if(strcmp(name, CONFIG_TIC_PATH) == 0)
-            {
-                console->config->save(console->config);
-                studioRomSaved(console->studio);
-                free(buffer);
-                return CART_SAVE_OK;
-            }
-            else
+            console->config->save(console->config);
+            studioRomSaved(console->studio);
+            return CART_SAVE_OK;
+        }
+        else
+        {
+            u8* buffer = NULL;
+            s32 size = 0;
+            bool saved = false;
+
+            if(tic_tool_has_ext(name, PngExt))
             {
-                s32 size = 0;
+                png_buffer cover;
 
-                if(tic_tool_has_ext(name, PngExt))
                 {
-                    png_buffer cover;
+                    enum{CoverWidth = 256};
 
+                    static const u8 Cartridge[] =
                     {
-                        enum{CoverWidth = 256};
+                        #include "../build/assets/cart.png.dat"
+                    };
 
-                        static const u8 Cartridge[] =
-                        {
-                            #include "../build/assets/cart.png.dat"
-                        };
+                    png_buffer template = {(u8*)Cartridge, sizeof Cartridge};
+                    png_img img = png_read(template, NULL);
 
-                        png_buffer template = {(u8*)Cartridge, sizeof Cartridge};
-                        png_img img = png_read(template, NULL);
+                    // draw screen
+                    {
+                        enum{PaddingLeft = 8, PaddingTop = 8};
 
-                        // draw screen
-                        {
-                            enum{PaddingLeft = 8, PaddingTop = 8};
+                        const tic_bank* bank = &tic->cart.bank0;
+                        const tic_rgb* pal = bank->palette.vbank0.colors;
+                        const u8* screen = bank->screen.data;
+                        u32* ptr = img.values + PaddingTop * CoverWidth + PaddingLeft;
+
+                        for(s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
+                            ptr[i / TIC80_WIDTH * CoverWidth + i % TIC80_WIDTH] = tic_rgba(pal + tic_tool_peek4(screen, i));
+                    }
 
-                            const tic_bank* bank = &tic->cart.bank0;
-                            const tic_rgb* pal = bank->palette.vbank0.colors;
-                            const u8* screen = bank->screen.data;
-                            u32* ptr = img.values + PaddingTop * CoverWidth + PaddingLeft;
+                    // draw title/author/desc
+                    {
+                        enum{Width = 224, Height = 40, PaddingTop = 162, PaddingLeft = 16, Scale = 2, Row = TIC_FONT_HEIGHT * 2 * Scale};
+
+                        tic_api_cls(tic, tic_color_dark_grey);
+
+                        const char* comment = tic_core_script_config(tic)->singleComment;
 
-                            for(s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
-                                ptr[i / TIC80_WIDTH * CoverWidth + i % TIC80_WIDTH] = tic_rgba(pal + tic_tool_peek4(screen, i));
+                        char* title = tic_tool_metatag(tic->cart.code.data, "title", comment);
+                        if(title)
+                        {
+                            drawShadowText(tic, title, 0, 0, tic_color_white, Scale);
+                            free(title);
                         }
 
-                        // draw title/author/desc
+                        char* author = tic_tool_metatag(tic->cart.code.data, "author", comment);
+                        if(author)
                         {
-                            enum{Width = 224, Height = 40, PaddingTop = 162, PaddingLeft = 16, Scale = 2, Row = TIC_FONT_HEIGHT * 2 * Scale};
-
-                            tic_api_cls(tic, tic_color_dark_grey);
-
-                            const char* comment = tic_core_script_config(tic)->singleComment;
-
-                            char* title = tic_tool_metatag(tic->cart.code.data, "title", comment);
-                            if(title)
-                            {
-                                drawShadowText(tic, title, 0, 0, tic_color_white, Scale);
-                                free(title);
-                            }
-
-                            char* author = tic_tool_metatag(tic->cart.code.data, "author", comment);
-                            if(author)
-                            {
-                                char buf[TICNAME_MAX];
-                                snprintf(buf, sizeof buf, "by %s", author);
-                                drawShadowText(tic, buf, 0, Row, tic_color_grey, Scale);
-                                free(author);
-                            }
-
-                            u32* ptr = img.values + PaddingTop * CoverWidth + PaddingLeft;
-                            const u8* screen = tic->ram->vram.screen.data;
-                            const tic_rgb* pal = getConfig(console->studio)->cart->bank0.palette.vbank0.colors;
-
-                            for(s32 y = 0; y < Height; y++)
-                                for(s32 x = 0; x < Width; x++)
-                                    ptr[CoverWidth * y + x] = tic_rgba(pal + tic_tool_peek4(screen, y * TIC80_WIDTH + x));
+                            char buf[TICNAME_MAX];
+                            snprintf(buf, sizeof buf, "by %s", author);
+                            drawShadowText(tic, buf, 0, Row, tic_color_grey, Scale);
+                            free(author);
                         }
 
-                        cover = png_write(img, (png_buffer){NULL, 0});
+                        u32* ptr = img.values + PaddingTop * CoverWidth + PaddingLeft;
+                        const u8* screen = tic->ram->vram.screen.data;
+                        const tic_rgb* pal = getConfig(console->studio)->cart->bank0.palette.vbank0.colors;
 
-                        free(img.data);
+                        for(s32 y = 0; y < Height; y++)
+                            for(s32 x = 0; x < Width; x++)
+                                ptr[CoverWidth * y + x] = tic_rgba(pal + tic_tool_peek4(screen, y * TIC80_WIDTH + x));
                     }
 
-                    png_buffer zip = png_create(sizeof(tic_cartridge));
+                    cover = png_write(img, (png_buffer){NULL, 0});
 
-                    {
-                        png_buffer cart = png_create(sizeof(tic_cartridge));
-                        cart.size = tic_cart_save(&tic->cart, cart.data);
-                        zip.size = tic_tool_zip(zip.data, zip.size, cart.data, cart.size);
-                        free(cart.data);
-                    }
+                    free(img.data);
+                }
 
-                    png_buffer result = png_encode(cover, zip);
-                    free(zip.data);
-                    free(cover.data);
+                png_buffer zip = png_create(sizeof(tic_cartridge));
 
-                    buffer = result.data;
-                    size = result.size;
-                }
-#if defined(TIC80_PRO)
-                else if(tic_project_ext(name))
                 {
-                    size = tic_project_save(name, buffer, &tic->cart);
+                    png_buffer cart = png_create(sizeof(tic_cartridge));
+                    cart.size = tic_cart_save(&tic->cart, cart.data);
+                    zip.size = tic_tool_zip(zip.data, zip.size, cart.data, cart.size);
+                    free(cart.data);
                 }
+
+                png_buffer result = png_encode(cover, zip);
+                free(zip.data);
+                free(cover.data);
+
+                buffer = result.data;
+                size = result.size;
+            }
+#if defined(TIC80_PRO)
+            else if(tic_project_ext(name))
+            {
+                // the project is written to the file by parts
+                ProjectSave project = {name, &tic->cart};
+                saved = tic_fs_save_parts(console->fs, name, saveProjectParts, &project, true);
+            }
 #endif
-                else
-                {
-                    name = getCartName(name);
+            else
+            {
+                name = getCartName(name);
+                buffer = (u8*)malloc(sizeof(tic_cartridge) * 3);
+
+                if(buffer)
                     size = tic_cart_save(&tic->cart, buffer);
-                }
+            }
 
-                if(size && tic_fs_save(console->fs, name, buffer, size, true))
-                {
-                    setCartName(console, name, tic_fs_path(console->fs, name));
-                    success = true;
-                    studioRomSaved(console->studio);
-                }
+            if(saved || (size && tic_fs_save(console->fs, name, buffer, size, true)))
+            {
+                setCartName(console, name, tic_fs_path(console->fs, name));
+                success = true;
+                studioRomSaved(console->studio);
             }
 
             free(buffer);
@@ -2585,6 +2605,154 @@ static void onEvalCommand(Console* console)
     commandDone(console);
 }
 
+static void onCompileCommand(Console* console)
+{
+    const tic_script_config* script_config = tic_core_script_config(console->tic);
+
+    if (script_config->compile)
+    {
+        switch(tic_core_compile(console->tic))
+        {
+        case tic_compile_done:
+            printBack(console, "\nbytecode has been embedded into the cart,"
+                "\nrun `compile` again after changing the code,"
+                "\nthe players run it with the --bytecode option only");
+            break;
+        case tic_compile_binary_used:
+            printError(console, "\nthe binary section is used by the cart");
+            break;
+        default:
+            printError(console, "\ncompilation failed, run the cart to see the error");
+        }
+    }
+    else printError(console, "\n'compile' not implemented for the script");
+
+    commandDone(console);
+}
+
+static void onStatsCommand(Console* console)
+{
+    bool enable = tic_core_stats(console->tic) == NULL;
+
+    if(console->desc->count)
+    {
+        const char* param = console->desc->params[0].key;
+
+        if(strcmp(param, "on") == 0) enable = true;
+        else if(strcmp(param, "off") == 0) enable = false;
+        else
+        {
+            printError(console, "\nusage: stats [on|off]");
+            commandDone(console);
+            return;
+        }
+    }
+
+    tic_core_stats_enable(console->tic, enable);
+    printBack(console, enable 
+        ? "\nframe stats are shown in the run mode" 
+        : "\nframe stats are hidden");
+
+    commandDone(console);
+}
+
+static void onProfileCommand(Console* console)
+{
+    tic_mem* tic = console->tic;
+    const char* param = console->desc->count ? console->desc->params[0].key : NULL;
+
+    if(param && strcmp(param, "start") == 0)
+    {
+        if(tic_core_profile_start(tic))
+            printBack(console, "\nprofiler started, run the cart and use `profile stop` to save the samples");
+        else printError(console, "\n'profile' not implemented for the script");
+    }
+    else if(param && strcmp(param, "stop") == 0)
+    {
+        tic_core_profile_stop(tic);
+
+        const char* name = console->desc->count > 1 ? console->desc->params[1].key : "profile.txt";
+        s32 size = 0;
+        void* data = tic_core_profile_export(tic, &size);
+
+        if(data)
+        {
+            if(tic_fs_save(console->fs, name, data, size, true))
+            {
+                printLine(console);
+                printBack(console, "collapsed stacks saved to ");
+                printFront(console, name);
+            }
+            else printError(console, "\nfile not saved :(");
+
+            free(data);
+        }
+        else printError(console, "\nno samples collected");
+    }
+    else printError(console, "\nusage: profile start|stop [file]");
+
+    commandDone(console);
+}
+
+static void onPatchCommandConfirmed(Console* console)
+{
+    const char* path = console->rom.path;
+
+    if(!console->desc->count)
+        printError(console, "\nusage: patch <delta>");
+    else if(!*path || !tic_tool_has_ext(path, CART_EXT))
+        printError(console, "\nload the " CART_EXT " cart to patch first");
+    else
+    {
+        s32 deltaSize = 0;
+        void* delta = tic_fs_load(console->fs, console->desc->params->key, &deltaSize);
+
+        if(delta) SCOPE(free(delta))
+        {
+            u8* cart = (u8*)newCart();
+            s32 size = 0;
+
+            SCOPE(free(cart))
+            {
+                s32 baseSize = 0;
+                void* base = fs_read(path, &baseSize);
+
+                if(base)
+                {
+                    size = tic_cart_patch(base, baseSize, delta, deltaSize, cart, sizeof(tic_cartridge));
+                    free(base);
+                }
+
+                if(!size)
+                    printError(console, "\nthe delta doesn't match the cart");
+                else if(!fs_write(path, cart, size) || !console->loadCart(console, path))
+                    printError(console, "\ncart not patched :(");
+                else
+                {
+                    printLine(console);
+                    printFront(console, console->rom.name);
+                    printBack(console, " patched");
+                }
+            }
+        }
+        else printError(console, "\nfile not found");
+    }
+
+    commandDone(console);
+}
+
+static void onPatchCommand(Console* console)
+{
+    if(studioCartChanged(console->studio))
+    {
+        confirmCommand(console, LoadWarningRows, COUNT_OF(LoadWarningRows), onPatchCommandConfirmed);
+    }
+    else
+    {
+        onPatchCommandConfirmed(console);
+    }
+}
+
 static void onDelCommandConfirmed(Console* console)
 {
     if(console->desc->count)
@@ -2832,6 +3000,35 @@ static const char HelpUsage[] = "help [<text>"
         NULL,                                                                           \
         NULL)                                                                           \
                                                                                         \
+    macro("compile",                                                                    \
+        NULL,                                                                           \
+        "precompile the code and embed bytecode into the binary section,\n"             \
+        "the bytecode is used until the code is changed\n"                              \
+        "and only when tic80 is started with --bytecode.",                              \
+        NULL,                                                                           \
+        onCompileCommand,                                                               \
+        NULL,                                                                           \
+        NULL)                                                                           \
+                                                                                        \
+    macro("stats",                                                                      \
+        NULL,                                                                           \
+        "show script, draw, blit and sound time per frame,\n"                           \
+        "VM heap size if the language reports it and the most called\n"                 \
+        "API functions in the run mode.",                                               \
+        "stats [on|off]",                                                               \
+        onStatsCommand,                                                                 \
+        NULL,                                                                           \
+        NULL)                                                                           \
+                                                                                        \
+    macro("profile",                                                                    \
+        NULL,                                                                           \
+        "sample the script call stacks every millisecond,\n"                            \
+        "`stop` saves them in the collapsed stacks format for flamegraphs.",            \
+        "profile start|stop [file]",                                                    \
+        onProfileCommand,                                                               \
+        NULL,                                                                           \
+        NULL)                                                                           \
+                                                                                        \
     macro("dir",                                                                        \
         "ls",                                                                           \
         "show list of local files.",                                                    \
@@ -2869,7 +3066,9 @@ static const char HelpUsage[] = "help [<text>"
         "export cart to HTML,\n"                                                        \
         "native build (win linux rpi mac),\n"                                           \
         "export sprites/map/... as a .png image "                                       \
-        "or export sfx and music to .wav files.",                                       \
+        "or export sfx and music to .wav files.\n"                                      \
+        "dict=1 makes the native builds smaller "                                       \
+        "with a cart that older players can't load.",                                   \
         "\nexport [" EXPORT_CMD_LIST(EXPORT_CMD_DEF) "...] "                            \
         "<file> [" EXPORT_KEYS_LIST(EXPORT_KEYS_DEF) "...]" ,                           \
         onExportCommand,                                                                \
@@ -2885,6 +3084,15 @@ static const char HelpUsage[] = "help [<text>"
         tabCompleteImport,                                                              \
         tabCompleteFiles)                                                               \
                                                                                         \
+    macro("patch",                                                                      \
+        NULL,                                                                           \
+        "apply the chunk delta made by `cartdelta` to the loaded cart,\n"               \
+        "the cart file is rewritten and loaded again.",                                 \
+        "patch <delta>",                                                                \
+        onPatchCommand,                                                                 \
+        tabCompleteFiles,                                                               \
+        NULL)                                                                           \
+                                                                                        \
     macro("del",                                                                        \
         NULL,                                                                           \
         "delete from the filesystem.",                                                  \
@@ -4218,7 +4426,7 @@ static bool cmdLoadCart(Console* console, const char* path)
     bool done = false;
 
     s32 size = 0;
-    void* data = fs_read(path, &size);
+    const void* data = fs_map(path, &size);
 
     if(data)
     {
@@ -4235,7 +4443,7 @@ static bool cmdLoadCart(Console* console, const char* path)
 
         if(tic_tool_has_ext(cartName, PngExt))
         {
-            tic_cartridge* cart = loadPngCart((png_buffer){data, size});
+            tic_cartridge* cart = loadPngCart((png_buffer){(u8*)data, size});
 
             if(cart)
             {
@@ -4257,7 +4465,7 @@ static bool cmdLoadCart(Console* console, const char* path)
         }
 #endif
 
-        free(data);
+        fs_unmap(data, size);
     }
 
     if(done)
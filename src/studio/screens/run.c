@@ -79,6 +79,28 @@ static const char* data2md5(const void* data, s32 length)
     return out;
 }
 
+static const char* cachePath(const char* name, const char* hash)
+{
+    static char path[TICNAME_MAX];
+    snprintf(path, sizeof path, TIC_LOCAL_VERSION "%s.%s", hash, name);
+
+    return path;
+}
+
+static void* onCacheLoad(void* data, const char* name, const char* hash, s32* size)
+{
+    Run* run = (Run*)data;
+
+    return tic_fs_loadroot(run->fs, cachePath(name, hash), size);
+}
+
+static void onCacheSave(void* data, const char* name, const char* hash, const void* buffer, s32 size)
+{
+    Run* run = (Run*)data;
+
+    tic_fs_saveroot(run->fs, cachePath(name, hash), buffer, size, true);
+}
+
 static void initPMemName(Run* run)
 {
     tic_mem* tic = run->tic;
@@ -150,7 +172,10 @@ void initRun(Run* run, Console* console, tic_fs* fs, Studio* studio)
             .exit = onExit,
             .data = run,
             .counter = getCounter,
-            .freq = getFreq
+            .freq = getFreq,
+            .cacheLoad = onCacheLoad,
+            .cacheSave = onCacheSave,
+            .budget = TIC_WATCHDOG_BUDGET,
         },
     };
 
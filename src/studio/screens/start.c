@@ -191,9 +191,9 @@ void initStart(Start* start, Studio* studio, const char* cart)
 #   endif
     
         s32 appSize = 0;
-        u8* app = fs_read(appPath, &appSize);
+        const u8* app = fs_map(appPath, &appSize);
     
-        if(app) SCOPE(free(app))
+        if(app) SCOPE(fs_unmap(app, appSize))
         {
             s32 size = appSize;
             const u8* ptr = app;
@@ -68,6 +68,25 @@ struct SurfItem
     bool project;
 };
 
+typedef struct SurfIndexItem SurfIndexItem;
+
+// the cover of a local cart, valid while the cart size and date are the same
+struct SurfIndexItem
+{
+    char* name;
+    u64 date;
+    s32 size;
+
+    tic_palette palette;
+
+    // zipped screen, NULL if the cart has no cover
+    u8* cover;
+    s32 coverSize;
+};
+
+static const char IndexMagic[] = {'T', 'I', 'D', 'X'};
+#define INDEX_VERSION 1
+
 typedef struct
 {
     SurfItem* items;
@@ -242,6 +261,288 @@ static s32 itemcmp(const void* a, const void* b)
     return 0;
 }
 
+// the index is sorted by name
+static s32 indexcmp(const void* a, const void* b)
+{
+    return strcmp(((const SurfIndexItem*)a)->name, ((const SurfIndexItem*)b)->name);
+}
+
+static SurfIndexItem* findIndexItem(Surf* surf, const char* name)
+{
+    const SurfIndexItem key = {.name = (char*)name};
+
+    return surf->index.count
+        ? bsearch(&key, surf->index.items, surf->index.count, sizeof key, indexcmp)
+        : NULL;
+}
+
+static SurfIndexItem* addIndexItem(Surf* surf, const char* name)
+{
+    s32 lo = 0, hi = surf->index.count;
+
+    while(lo < hi)
+    {
+        s32 mid = (lo + hi) / 2;
+
+        if(strcmp(surf->index.items[mid].name, name) < 0)
+            lo = mid + 1;
+        else hi = mid;
+    }
+
+    surf->index.items = realloc(surf->index.items, sizeof(SurfIndexItem) * ++surf->index.count);
+
+    SurfIndexItem* entry = &surf->index.items[lo];
+    memmove(entry + 1, entry, sizeof(SurfIndexItem) * (surf->index.count - 1 - lo));
+    *entry = (SurfIndexItem){.name = strdup(name)};
+
+    return entry;
+}
+
+static void freeIndex(Surf* surf)
+{
+    for(s32 i = 0; i < surf->index.count; i++)
+    {
+        SurfIndexItem* entry = &surf->index.items[i];
+
+        free(entry->name);
+        FREE(entry->cover);
+    }
+
+    FREE(surf->index.items);
+    surf->index.count = 0;
+    surf->index.dirty = false;
+}
+
+static inline void writeIndex(u8** ptr, const void* data, s32 size)
+{
+    memcpy(*ptr, data, size);
+    *ptr += size;
+}
+
+static inline bool readIndex(const u8** ptr, const u8* end, void* data, s32 size)
+{
+    if(end - *ptr < size)
+        return false;
+
+    memcpy(data, *ptr, size);
+    *ptr += size;
+
+    return true;
+}
+
+static bool readIndexItem(const u8** ptr, const u8* end, SurfIndexItem* entry)
+{
+    s32 nameSize = 0;
+
+    if(!readIndex(ptr, end, &entry->date, sizeof entry->date)
+        || !readIndex(ptr, end, &entry->size, sizeof entry->size)
+        || !readIndex(ptr, end, &nameSize, sizeof nameSize)
+        || nameSize <= 0 || nameSize >= TICNAME_MAX || end - *ptr < nameSize)
+        return false;
+
+    entry->name = malloc(nameSize + 1);
+    readIndex(ptr, end, entry->name, nameSize);
+    entry->name[nameSize] = '\0';
+
+    if(readIndex(ptr, end, &entry->coverSize, sizeof entry->coverSize))
+    {
+        if(entry->coverSize == 0)
+            return true;
+
+        if(entry->coverSize > 0 
+            && entry->coverSize <= sizeof(tic_screen)
+            && readIndex(ptr, end, &entry->palette, sizeof entry->palette)
+            && end - *ptr >= entry->coverSize)
+        {
+            entry->cover = malloc(entry->coverSize);
+            readIndex(ptr, end, entry->cover, entry->coverSize);
+            return true;
+        }
+    }
+
+    free(entry->name);
+    return false;
+}
+
+// the index of the current directory is kept in the cache,
+// the carts with the same size and date are not parsed again
+static void loadIndex(Surf* surf)
+{
+    freeIndex(surf);
+
+    char dir[TICNAME_MAX];
+    tic_fs_dir(surf->fs, dir);
+    sprintf(surf->index.path, TIC_CACHE "%08x.idx", tic_tool_crc32(dir, (s32)strlen(dir)));
+
+    s32 size = 0;
+    u8* data = tic_fs_loadroot(surf->fs, surf->index.path, &size);
+
+    if(!data)
+        return;
+
+    const u8 *ptr = data, *end = data + size;
+    char magic[sizeof IndexMagic];
+    u32 version = 0;
+    s32 count = 0;
+
+    if(readIndex(&ptr, end, magic, sizeof magic)
+        && memcmp(magic, IndexMagic, sizeof magic) == 0
+        && readIndex(&ptr, end, &version, sizeof version)
+        && version == INDEX_VERSION
+        && readIndex(&ptr, end, &count, sizeof count)
+        && count > 0 && count <= size)
+    {
+        surf->index.items = calloc(count, sizeof(SurfIndexItem));
+
+        while(surf->index.count < count 
+            && readIndexItem(&ptr, end, &surf->index.items[surf->index.count]))
+            surf->index.count++;
+
+        qsort(surf->index.items, surf->index.count, sizeof *surf->index.items, indexcmp);
+    }
+
+    free(data);
+}
+
+static void saveIndex(Surf* surf)
+{
+    if(!surf->index.dirty)
+        return;
+
+    surf->index.dirty = false;
+
+    // the removed carts are dropped
+    bool* found = calloc(surf->index.count, sizeof(bool));
+
+    if(!found)
+        return;
+
+    for(s32 i = 0; i < surf->menu.count; i++)
+    {
+        const SurfItem* item = &surf->menu.items[i];
+        const SurfIndexItem* entry = item->dir ? NULL : findIndexItem(surf, item->name);
+
+        if(entry)
+            found[entry - surf->index.items] = true;
+    }
+
+    s32 count = 0;
+    s32 size = sizeof IndexMagic + sizeof(u32) + sizeof(s32);
+
+    for(s32 i = 0; i < surf->index.count; i++)
+    {
+        SurfIndexItem* entry = &surf->index.items[i];
+
+        if(found[i])
+        {
+            surf->index.items[count++] = *entry;
+
+            size += sizeof entry->date + sizeof entry->size + sizeof(s32) + (s32)strlen(entry->name) + sizeof entry->coverSize;
+
+            if(entry->cover)
+                size += sizeof entry->palette + entry->coverSize;
+        }
+        else
+        {
+            free(entry->name);
+            FREE(entry->cover);
+        }
+    }
+
+    free(found);
+    surf->index.count = count;
+
+    u8* data = malloc(size);
+
+    if(data)
+    {
+        u8* ptr = data;
+        u32 version = INDEX_VERSION;
+
+        writeIndex(&ptr, IndexMagic, sizeof IndexMagic);
+        writeIndex(&ptr, &version, sizeof version);
+        writeIndex(&ptr, &count, sizeof count);
+
+        for(s32 i = 0; i < count; i++)
+        {
+            const SurfIndexItem* entry = &surf->index.items[i];
+            s32 nameSize = (s32)strlen(entry->name);
+
+            writeIndex(&ptr, &entry->date, sizeof entry->date);
+            writeIndex(&ptr, &entry->size, sizeof entry->size);
+            writeIndex(&ptr, &nameSize, sizeof nameSize);
+            writeIndex(&ptr, entry->name, nameSize);
+            writeIndex(&ptr, &entry->coverSize, sizeof entry->coverSize);
+
+            if(entry->cover)
+            {
+                writeIndex(&ptr, &entry->palette, sizeof entry->palette);
+                writeIndex(&ptr, entry->cover, entry->coverSize);
+            }
+        }
+
+        tic_fs_saveroot(surf->fs, surf->index.path, data, size, true);
+        free(data);
+    }
+}
+
+static bool loadIndexCover(Surf* surf, SurfItem* item, u64 date, s32 size)
+{
+    const SurfIndexItem* entry = findIndexItem(surf, item->name);
+
+    if(!entry || entry->date != date || entry->size != size)
+        return false;
+
+    if(entry->cover)
+    {
+        tic_screen* cover = malloc(sizeof(tic_screen));
+
+        if(tic_tool_unzip(cover, sizeof(tic_screen), entry->cover, entry->coverSize) != sizeof(tic_screen))
+        {
+            free(cover);
+            return false;
+        }
+
+        item->cover = cover;
+        memcpy((item->palette = malloc(sizeof(tic_palette))), &entry->palette, sizeof(tic_palette));
+    }
+
+    return true;
+}
+
+static void updateIndex(Surf* surf, const SurfItem* item, u64 date, s32 size)
+{
+    u8 buffer[sizeof(tic_screen)];
+    s32 coverSize = 0;
+
+    if(item->cover)
+    {
+        coverSize = tic_tool_zip(buffer, sizeof buffer, item->cover, sizeof(tic_screen));
+
+        if(!coverSize)
+            return;
+    }
+
+    SurfIndexItem* entry = findIndexItem(surf, item->name);
+
+    if(!entry)
+        entry = addIndexItem(surf, item->name);
+
+    FREE(entry->cover);
+
+    entry->date = date;
+    entry->size = size;
+    entry->coverSize = coverSize;
+
+    if(item->cover)
+    {
+        memcpy((entry->cover = malloc(coverSize)), buffer, coverSize);
+        memcpy(&entry->palette, item->palette, sizeof(tic_palette));
+    }
+
+    surf->index.dirty = true;
+}
+
 static void addMenuItemsDone(void* data)
 {
     AddMenuItemData* addMenuItemData = data;
@@ -251,7 +552,10 @@ static void addMenuItemsDone(void* data)
     surf->menu.count = addMenuItemData->count;
 
     if(!tic_fs_ispubdir(surf->fs))
+    {
         qsort(surf->menu.items, surf->menu.count, sizeof *surf->menu.items, itemcmp);
+        loadIndex(surf);
+    }
 
     if (addMenuItemData->done)
         addMenuItemData->done(addMenuItemData->data);
@@ -263,6 +567,9 @@ static void addMenuItemsDone(void* data)
 
 static void resetMenu(Surf* surf)
 {
+    saveIndex(surf);
+    freeIndex(surf);
+
     if(surf->menu.items)
     {
         for(s32 i = 0; i < surf->menu.count; i++)
@@ -388,6 +695,12 @@ static void loadCover(Surf* surf)
 
     if(!tic_fs_ispubdir(surf->fs))
     {
+        const char* path = tic_fs_path(surf->fs, item->name);
+        u64 date = fs_date(path);
+        s32 fileSize = fs_size(path);
+
+        if(date && loadIndexCover(surf, item, date, fileSize))
+            return;
 
         s32 size = 0;
         void* data = tic_fs_load(surf->fs, item->name, &size);
@@ -414,8 +727,8 @@ static void loadCover(Surf* surf)
                 else if(tic_project_ext(item->name))
                     tic_project_load(item->name, data, size, cart);
 #endif
-                else
-                    tic_cart_load(cart, data, size);
+                // the cover only needs the screen and the palette
+                else tic_cart_load_sections(cart, data, size, tic_cart_screen | tic_cart_palette);
 
                 if(!EMPTY(cart->bank0.screen.data) && !EMPTY(cart->bank0.palette.vbank0.data))
                 {
@@ -423,6 +736,9 @@ static void loadCover(Surf* surf)
                     memcpy((item->cover = malloc(sizeof(tic_screen))), &cart->bank0.screen, sizeof(tic_screen));
                 }
 
+                if(date)
+                    updateIndex(surf, item, date, fileSize);
+
                 free(cart);
             }
 
@@ -47,6 +47,15 @@ struct Surf
         s32 count;
     } menu;
 
+    // the covers of the local carts, cached per directory
+    struct
+    {
+        struct SurfIndexItem* items;
+        s32 count;
+        char path[TICNAME_MAX];
+        bool dirty;
+    } index;
+
     struct
     {
         struct
@@ -1949,6 +1949,67 @@ static void recordFrame(Studio* studio, u32* pixels)
     }
 }
 
+static void drawTextRaw(Studio* studio, u32* frame, s32 sx, s32 sy, const char* text, tic_color color)
+{
+    const tic_bank* bank = &getConfig(studio)->cart->bank0;
+    const u8* font = studio->systemFont.regular.data;
+    u32 rgba = tic_rgba(&bank->palette.vbank0.colors[color]);
+
+    for(const char* c = text; *c; c++, sx += TIC_FONT_WIDTH)
+        for(s32 y = 0; y < TIC_FONT_HEIGHT; y++)
+            for(s32 x = 0; x < TIC_FONT_WIDTH; x++)
+                if(font[(u8)*c * BITS_IN_BYTE + y] & (1 << x))
+                    frame[sx + x + (sy + y) * TIC80_FULLWIDTH] = rgba;
+}
+
+static void drawStats(Studio* studio, u32* frame)
+{
+    const tic80_stats* stats = tic_core_stats(studio->tic);
+
+    if(!stats) return;
+
+    enum {Times = 7, Top = 3, Rows = Times + Top, Width = 18 * TIC_FONT_WIDTH, Height = Rows * (TIC_FONT_HEIGHT + 1) + 2};
+
+    s32 sx = TIC80_MARGIN_LEFT, sy = TIC80_MARGIN_TOP;
+    u32 bg = tic_rgba(&getConfig(studio)->cart->bank0.palette.vbank0.colors[tic_color_black]);
+
+    for(s32 y = sy; y < sy + Height; y++)
+        for(s32 x = sx; x < sx + Width; x++)
+            frame[x + y * TIC80_FULLWIDTH] = bg;
+
+    char rows[Rows][32] = {0};
+
+    sprintf(rows[0], "TIC   %6uus", stats->time.tick);
+    sprintf(rows[1], "SCN   %6uus", stats->time.scanline);
+    sprintf(rows[2], "BDR   %6uus", stats->time.border);
+    sprintf(rows[3], "DRAW  %6uus", stats->time.draw);
+    sprintf(rows[4], "BLIT  %6uus", stats->time.blit);
+    sprintf(rows[5], "SOUND %6uus", stats->time.sound);
+
+    // only the languages using the core allocator can tell
+    if(stats->hasHeap)
+        sprintf(rows[6], "HEAP  %6uKB", stats->heap / 1024);
+
+    // the most called API functions
+    s32 top[Top] = {-1, -1, -1};
+    for(s32 i = 0; i < stats->calls.count; i++)
+        if(stats->calls.values[i])
+            for(s32 t = 0; t < Top; t++)
+                if(top[t] < 0 || stats->calls.values[i] > stats->calls.values[top[t]])
+                {
+                    memmove(top + t + 1, top + t, (Top - t - 1) * sizeof *top);
+                    top[t] = i;
+                    break;
+                }
+
+    for(s32 t = 0; t < Top && top[t] >= 0; t++)
+        sprintf(rows[Times + t], "%-6s%6u", stats->calls.names[top[t]], stats->calls.values[top[t]]);
+
+    for(s32 i = 0; i < Rows; i++)
+        drawTextRaw(studio, frame, sx + 1, sy + 2 + i * (TIC_FONT_HEIGHT + 1), rows[i], 
+            i < Times ? tic_color_white : tic_color_light_grey);
+}
+
 #endif
 
 static void renderStudio(Studio* studio)
@@ -2262,6 +2323,9 @@ void studio_tick(Studio* studio, tic80_input input)
         if(isRecordFrame(studio))
             recordFrame(studio, tic->product.screen);
 
+        if(studio->mode == TIC_RUN_MODE)
+            drawStats(studio, tic->product.screen);
+
         drawPopup(studio);
 #endif
     }
@@ -2479,7 +2543,7 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
         .samplerate = samplerate,
         .net = tic_net_create(TIC_WEBSITE),
 #endif
-        .tic = tic_core_create(samplerate, format),
+        .tic = tic_core_create_ex(samplerate, format, args.threads),
     };
 
 
@@ -2578,6 +2642,9 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
     studio->config->data.soft               |= args.soft;
     studio->config->data.cli                |= args.cli;
 
+    // the engines don't verify the bytecode, only the user can trust the carts
+    tic_core_trust_bytecode(studio->tic, args.bytecode);
+
     studioConfigChanged(studio);
 
     if(args.cli)
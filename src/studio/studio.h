@@ -75,6 +75,8 @@
     macro(soft,         bool,   BOOLEAN,    "",         "use software rendering")           \
     macro(fs,           char*,  STRING,     "=<str>",   "path to the file system folder")   \
     macro(scale,        s32,    INTEGER,    "=<int>",   "main window scale")                \
+    macro(threads,      s32,    INTEGER,    "=<int>",   "extra threads for heavy drawing")  \
+    macro(bytecode,     bool,   BOOLEAN,    "",         "run bytecode embedded in carts")   \
     macro(cmd,          char*,  STRING,     "=<str>",   "run commands in the console")      \
     macro(keepcmd,      bool,   BOOLEAN,    "",         "re-execute commands on every run") \
     macro(version,      bool,   BOOLEAN,    "",         "print program version")            \
@@ -28,6 +28,13 @@
 #include "tools.h"
 #include "cart.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define REFS_ADD(refs, value) (_InterlockedExchangeAdd((volatile long*)(refs), (value)) + (value))
+#else
+#define REFS_ADD(refs, value) __atomic_add_fetch((refs), (value), __ATOMIC_ACQ_REL)
+#endif
+
 static void onTrace(void* data, const char* text, u8 color)
 {
     tic80* tic = (tic80*)data;
@@ -57,14 +64,88 @@ tic80* tic80_create(s32 samplerate, tic80_pixel_color_format format)
     return &tic_core_create(samplerate, format)->product;
 }
 
+struct tic80_cart
+{
+    tic_cartridge cart;
+
+    // zero for the carts parsed into the caller's memory, they are never freed
+    s32 refs;
+};
+
+// the instances running the cart can be on different threads
+static void retainCart(const tic80_cart* cart)
+{
+    if(cart->refs)
+        REFS_ADD((s32*)&cart->refs, 1);
+}
+
+static void releaseCart(const tic80_cart* cart)
+{
+    if(cart->refs && REFS_ADD((s32*)&cart->refs, -1) == 0)
+        free((tic80_cart*)cart);
+}
+
+// tic80_cart embeds the cartridge as its first member
+static void dropCart(tic_mem* mem)
+{
+    const tic_cartridge* rom = tic_core_rom(mem);
+
+    tic_core_load_rom(mem, NULL);
+
+    if(rom != &mem->cart)
+        releaseCart((const tic80_cart*)rom);
+}
+
 TIC80_API void tic80_load(tic80* tic, void* cart, s32 size)
 {
     tic_mem* mem = (tic_mem*)tic;
 
+    dropCart(mem);
     tic_cart_load(&mem->cart, cart, size);
     tic_api_reset(mem);
 }
 
+TIC80_API s32 tic80_cart_size()
+{
+    return sizeof(tic80_cart);
+}
+
+TIC80_API void tic80_cart_parse(tic80_cart* dst, const void* cart, s32 size)
+{
+    tic_cart_load(&dst->cart, cart, size);
+    dst->refs = 0;
+}
+
+TIC80_API tic80_cart* tic80_cart_create(const void* cart, s32 size)
+{
+    tic80_cart* dst = malloc(sizeof(tic80_cart));
+
+    if(dst)
+    {
+        tic80_cart_parse(dst, cart, size);
+        dst->refs = 1;
+    }
+
+    return dst;
+}
+
+TIC80_API void tic80_cart_release(tic80_cart* cart)
+{
+    if(cart)
+        releaseCart(cart);
+}
+
+TIC80_API void tic80_load_ex(tic80* tic, const tic80_cart* cart)
+{
+    tic_mem* mem = (tic_mem*)tic;
+
+    // retained first, the instance can be reloaded with the same cart
+    retainCart(cart);
+    dropCart(mem);
+    tic_core_load_rom(mem, &cart->cart);
+    tic_api_reset(mem);
+}
+
 TIC80_API void tic80_tick(tic80* tic, tic80_input input, CounterCallback counter, FreqCallback freq)
 {
     tic_mem* mem = (tic_mem*)tic;
@@ -97,5 +178,18 @@ TIC80_API void tic80_sound(tic80* tic)
 TIC80_API void tic80_delete(tic80* tic)
 {
     tic_mem* mem = (tic_mem*)tic;
+    dropCart(mem);
     tic_core_close(mem);
 }
+
+TIC80_API void tic80_stats_enable(tic80* tic, bool enable)
+{
+    tic_mem* mem = (tic_mem*)tic;
+    tic_core_stats_enable(mem, enable);
+}
+
+TIC80_API const tic80_stats* tic80_stats_get(tic80* tic)
+{
+    tic_mem* mem = (tic_mem*)tic;
+    return tic_core_stats(mem);
+}
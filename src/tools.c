@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "tools.h"
+#include "ext/md5.h"
 
 #include <ctype.h>
 #include <string.h>
@@ -204,25 +205,26 @@ bool tic_tool_noise(const tic_waveform* wave)
     return FLAT4(wave->data) && *wave->data % 0xff == 0;
 }
 
+// hex digit values plus one, zero for the other chars
+static const u8 HexDigits[256] =
+{
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
 void tic_tool_str2buf(const char* str, s32 size, void* buf, bool flip)
 {
-    char val[] = "0x00";
-    const char* ptr = str;
+    const u8* ptr = (const u8*)str;
+    u8* dst = buf;
 
-    for(s32 i = 0; i < size/2; i++)
+    for(s32 i = 0; i < size/2; i++, ptr += 2)
     {
-        if(flip)
-        {
-            val[3] = *ptr++;
-            val[2] = *ptr++;
-        }
-        else
-        {
-            val[2] = *ptr++;
-            val[3] = *ptr++;
-        }
+        u8 hi = HexDigits[ptr[flip]];
+        u8 lo = HexDigits[ptr[!flip]];
 
-        ((u8*)buf)[i] = (u8)strtol(val, NULL, 16);
+        // the pair is read up to the first wrong digit
+        *dst++ = hi ? lo ? (hi - 1) << 4 | (lo - 1) : hi - 1 : 0;
     }
 }
 
@@ -267,4 +269,12 @@ char* tic_tool_metatag(const char* code, const char* tag, const char* comment)
     }
 
     return NULL;
-}
\ No newline at end of file
+}
+
+void tic_tool_md5(const void* data, s32 size, u8 digest[TIC_MD5_SIZE])
+{
+    MD5_CTX c;
+    MD5_Init(&c);
+    MD5_Update(&c, data, size);
+    MD5_Final(digest, &c);
+}
@@ -99,7 +99,12 @@ void    tic_tool_set_track_row_sfx(tic_track_row* row, s32 sfx);
 void    tic_tool_str2buf(const char* str, s32 size, void* buf, bool flip);
 
 u32     tic_tool_zip(void* dest, s32 destSize, const void* source, s32 size);
+u32     tic_tool_zip_cart(void* dest, s32 destSize, const void* source, s32 size);
 u32     tic_tool_unzip(void* dest, s32 bufSize, const void* source, s32 size);
+u32     tic_tool_crc32(const void* data, s32 size);
+
+#define TIC_MD5_SIZE 16
+void    tic_tool_md5(const void* data, s32 size, u8 digest[TIC_MD5_SIZE]);
 
 bool    tic_tool_empty(const void* buffer, s32 size);
 #define EMPTY(BUFFER) (tic_tool_empty((BUFFER), sizeof (BUFFER)))
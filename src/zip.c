@@ -24,14 +24,156 @@
 
 #include <zlib.h>
 
+// the preset dictionary of the carts zipped with tic_tool_zip_cart,
+// it's identified by its checksum, so it must never change
+static const char CartDict[] =
+    // the API and the common script words
+    "local function end then else elseif return for while do and not or nil true false "
+    "math.floor(math.random(math.sin(math.cos(math.abs(math.min(math.max(math.pi table.insert("
+    "#print(cls(pix(line(rect(rectb(spr(btn(btnp(sfx(map(mget(mset(peek(poke(peek1(poke1("
+    "peek2(poke2(peek4(poke4(memcpy(memset(trace(pmem(time(tstamp(exit(font(mouse(circ("
+    "circb(elli(ellib(tri(trib(ttri(clip(music(sync(vbank(key(keyp(fget(fset(\n"
+    "function BDR(row)\n"
+    "end\n"
+    "\n"
+    "function SCN(row)\n"
+    "end\n"
+    "\n"
+    "function OVR()\n"
+    "end\n"
+    "\n"
+    "function BOOT()\n"
+    "end\n"
+    "\n"
+    // the default palette, waveforms, sfx, music and sprites chunks
+    "\x0c\x30\x00\x00\x14\x0c\x1c\x44\x24\x34\x30\x34\x6d\x4e\x4a\x4e"
+    "\x85\x4c\x30\x34\x65\x24\xd0\x46\x48\x75\x71\x61\x59\x7d\xce\xb2"
+    "\x3c\x40\x85\x95\xa1\x6d\xaa\x2c\xd2\xaa\x99\x6d\xc2\xca\xda\xd4"
+    "\x5e\xde\xee\xd6\x0a\x30\x00\x00\x00\x00\x00\x00\xff\xff\xff\xff"
+    "\x00\x00\x00\x00\xff\xff\xff\xff\x10\x32\x54\x76\x98\xba\xdc\xfe"
+    "\xef\xcd\xab\x89\x67\x45\x23\x01\x10\x32\x54\x76\x98\xba\xdc\xfe"
+    "\x10\x32\x54\x76\x98\xba\xdc\xfe\x11\x00\x00\x00\x0e\x01\x00\x00"
+    "\x01\x09\x3e\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x03\x04\x01\xa0\x02\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\xce\xcc\xcc\xcc\xcc\x88\x88\x88\xac"
+    "\xaa\xaa\xaa\xac\x88\x88\x88\xac\xcc\xcc\xcc\xac\xcc\xc0\xcc\xac"
+    "\xcc\xc0\xcc\xac\xcc\xc0\xcc\xcc\xcc\xec\xee\x88\x88\xcc\xee\xaa"
+    "\xaa\xc0\xee\x88\xa8\xc0\xee\xcc\xac\xc0\xcc\xc0\xac\xc0\xc0\xc0"
+    "\xac\xc0\xc0\xc0\xac\xc0\xc0\xce\xcc\xcc\xcc\xcc\x88\x88\x88\xac"
+    "\xaa\xaa\xaa\xac\x88\x88\x88\xac\xcc\xcc\xcc\xac\xcc\xcc\xcc\xac"
+    "\xcc\xc0\xcc\xac\xcc\xc0\xcc\xcc\xcc\xec\xee\x88\x88\xcc\xee\xaa"
+    "\xaa\xc0\xee\x88\xa8\xc0\xee\xcc\xac\xc0\xcc\xcc\xac\xc0\xc0\xc0"
+    "\xac\xc0\xc0\xc0\xac\xc0\xc0\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\xac\xcc\xcc\xcc\xac\xaa\xaa\xaa\xac"
+    "\xaa\xac\xaa\xac\xaa\xca\xcc\xac\xaa\xaa\xaa\x8c\x88\x88\x88\xcc"
+    "\x00\xc0\xcc\xce\xcc\xcc\xce\xcc\xac\x00\xcc\xaa\xaa\xc0\xec\xac"
+    "\xaa\xc0\xee\xaa\xaa\xc0\xee\xaa\xaa\xc0\xee\x88\x88\xcc\xee\x00"
+    "\xc0\xec\xee\xcc\xcc\xee\xee\xac\xcc\xcc\xcc\xac\xaa\xaa\xaa\xac"
+    "\xaa\xac\xaa\xac\xaa\xca\xcc\xac\xaa\xaa\xaa\x8c\x88\x88\x88\xcc"
+    "\x00\xc0\xcc\xce\xcc\xcc\xce\xcc\xac\x00\xcc\xaa\xaa\xc0\xec\xac"
+    "\xaa\xc0\xee\xaa\xaa\xc0\xee\xaa\xaa\xc0\xee\x88\x88\xcc\xee\x00"
+    "\xc0\xec\xee\xcc\xcc\xee\xee"
+    // the code header
+    "-- title:   game title\n"
+    "-- author:  game developer, email, etc.\n"
+    "-- desc:    short description\n"
+    "-- site:    website link\n"
+    "-- license: MIT License (change this to your license of choice)\n"
+    "-- version: 0.1\n"
+    "-- script:  lua";
+
+static u32 deflateBuffer(void* dest, s32 destSize, const void* source, s32 size, const void* dict, s32 dictSize)
+{
+    z_stream stream =
+    {
+        .next_in = (Bytef*)source,
+        .avail_in = size,
+        .next_out = dest,
+        .avail_out = destSize,
+    };
+
+    if(deflateInit(&stream, Z_BEST_COMPRESSION) != Z_OK)
+        return 0;
+
+    s32 result = dict 
+        ? deflateSetDictionary(&stream, dict, dictSize) 
+        : Z_OK;
+
+    if(result == Z_OK)
+        result = deflate(&stream, Z_FINISH);
+
+    u32 total = stream.total_out;
+    deflateEnd(&stream);
+
+    return result == Z_STREAM_END ? total : 0;
+}
+
 u32 tic_tool_zip(void* dest, s32 destSize, const void* source, s32 size)
 {
-    unsigned long destSizeLong = destSize;
-    return compress2(dest, &destSizeLong, source, size, Z_BEST_COMPRESSION) == Z_OK ? destSizeLong : 0;
+    return deflateBuffer(dest, destSize, source, size, NULL, 0);
+}
+
+// opt-in only: the players without CartDict fail on these carts
+// with Z_NEED_DICT, so the saved carts keep the plain format
+u32 tic_tool_zip_cart(void* dest, s32 destSize, const void* source, s32 size)
+{
+    return deflateBuffer(dest, destSize, source, size, CartDict, sizeof CartDict - 1);
 }
 
 u32 tic_tool_unzip(void* dest, s32 destSize, const void* source, s32 size)
 {
-    unsigned long destSizeLong = destSize;
-    return uncompress(dest, &destSizeLong, source, size) == Z_OK ? destSizeLong : 0;
+    z_stream stream =
+    {
+        .next_in = (Bytef*)source,
+        .avail_in = size,
+        .next_out = dest,
+        .avail_out = destSize,
+    };
+
+    if(inflateInit(&stream) != Z_OK)
+        return 0;
+
+    s32 result = inflate(&stream, Z_FINISH);
+
+    // zipped with the cart dictionary, zlib checks its checksum
+    if(result == Z_NEED_DICT 
+        && inflateSetDictionary(&stream, (const Bytef*)CartDict, sizeof CartDict - 1) == Z_OK)
+        result = inflate(&stream, Z_FINISH);
+
+    u32 total = stream.total_out;
+    inflateEnd(&stream);
+
+    return result == Z_STREAM_END ? total : 0;
+}
+
+u32 tic_tool_crc32(const void* data, s32 size)
+{
+    return crc32(crc32(0L, Z_NULL, 0), data, size);
 }
@@ -362,6 +362,10 @@ WASM_IMPORT("vbank")
 // Switch the 16kb of banked video RAM.
 int8_t vbank(int8_t bank);
 
+WASM_IMPORT("rowfx")
+// Apply a table in RAM with the palette, offset and border color of every screen row.
+void rowfx(int32_t address, int32_t mask, int32_t bank);
+
 // ---------------------------
 //      Utility Functions
 // ---------------------------
@@ -144,6 +144,7 @@ pub mod sys {
             h: i32,
         );
         pub fn sync(mask: i32, bank: u8, to_cart: bool);
+        pub fn rowfx(address: i32, mask: i32, bank: i32);
         pub fn time() -> f32;
         pub fn tstamp() -> u32;
         pub fn trace(text: *const u8, color: u8);
@@ -716,6 +717,10 @@ pub unsafe fn vbank(bank: u8) {
     sys::vbank(bank);
 }
 
+pub unsafe fn rowfx(address: i32, mask: i32, bank: i32) {
+    sys::rowfx(address, mask, bank);
+}
+
 pub fn pmem_set(address: i32, value: i32) {
     unsafe {
         sys::pmem(address, value as i64);